@@ -0,0 +1,136 @@
+#ifndef SJTU_BENCH_HPP
+#define SJTU_BENCH_HPP
+
+// shared harness of the benchmarks: timing, command line options and csv/json records.
+// every record is one line keyed by (suite, impl, op, elem_bytes, n, threads),
+// which is what bench_compare matches a run against its baseline by.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace bench {
+
+    struct options {
+        long long min_n = 10;
+        long long max_n = 1000000;
+        double min_seconds = 0.02;
+        bool json = false;
+        const char *out = nullptr;
+        const char *filter = nullptr;
+    };
+
+    /**
+     * --min-n N --max-n N --min-time SECONDS --format csv|json --out FILE --filter SUBSTRING
+     * unknown arguments are left to the caller.
+     */
+    inline options parse(int argc, char *argv[]) {
+        options opt;
+        for (int i = 1; i + 1 < argc; i++) {
+            if (!strcmp(argv[i], "--min-n")) opt.min_n = atoll(argv[++i]);
+            else if (!strcmp(argv[i], "--max-n")) opt.max_n = atoll(argv[++i]);
+            else if (!strcmp(argv[i], "--min-time")) opt.min_seconds = atof(argv[++i]);
+            else if (!strcmp(argv[i], "--format")) opt.json = !strcmp(argv[++i], "json");
+            else if (!strcmp(argv[i], "--out")) opt.out = argv[++i];
+            else if (!strcmp(argv[i], "--filter")) opt.filter = argv[++i];
+        }
+        return opt;
+    }
+
+    class reporter {
+    private:
+        FILE *file;
+        bool json, first;
+    public:
+        explicit reporter(const options &opt) : file(stdout), json(opt.json), first(true) {
+            if (opt.out != nullptr) file = fopen(opt.out, "w");
+            if (file == nullptr) {
+                fprintf(stderr, "can not open %s\n", opt.out);
+                exit(2);
+            }
+            if (json) fprintf(file, "[\n");
+            else fprintf(file, "suite,impl,op,elem_bytes,n,threads,seconds,ns_per_op\n");
+        }
+
+        reporter(const reporter &) = delete;
+
+        ~reporter() {
+            if (json) fprintf(file, "\n]\n");
+            if (file != stdout) fclose(file);
+        }
+
+        /**
+         * seconds is the time of one run doing ops operations.
+         */
+        void record(const char *suite, const std::string &impl, const char *op, int elem_bytes, long long n,
+                    int threads, double seconds, long long ops) {
+            double ns = ops > 0 ? seconds * 1e9 / ops : 0;
+            if (json) {
+                fprintf(file, "%s  {\"suite\": \"%s\", \"impl\": \"%s\", \"op\": \"%s\", \"elem_bytes\": %d, \"n\": %lld, "
+                              "\"threads\": %d, \"seconds\": %.9f, \"ns_per_op\": %.3f}",
+                        first ? "" : ",\n", suite, impl.c_str(), op, elem_bytes, n, threads, seconds, ns);
+            } else {
+                fprintf(file, "%s,%s,%s,%d,%lld,%d,%.9f,%.3f\n", suite, impl.c_str(), op, elem_bytes, n, threads,
+                        seconds, ns);
+            }
+            first = false;
+            fflush(file);
+        }
+    };
+
+    inline double now() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * run body(), which builds its own input, until min_seconds have passed (at least once)
+     * and return the fastest run. setup() runs before every body() outside the timing.
+     */
+    template<class Setup, class Body>
+    double measure(double min_seconds, Setup setup, Body body) {
+        double best = 1e100, spent = 0;
+        do {
+            setup();
+            double start = now();
+            body();
+            double t = now() - start;
+            if (t < best) best = t;
+            spent += t;
+        } while (spent < min_seconds);
+        return best;
+    }
+
+    template<class Body>
+    double measure(double min_seconds, Body body) {
+        return measure(min_seconds, []() {}, body);
+    }
+
+    /**
+     * keeps the optimizer from dropping a computed value
+     */
+    template<class T>
+    inline void keep(const T &value) {
+        asm volatile("" : : "r"(&value) : "memory");
+    }
+
+    /**
+     * xorshift, the same stream for every implementation under test
+     */
+    class rng {
+    private:
+        unsigned long long state;
+    public:
+        explicit rng(unsigned long long seed = 88172645463325252ull) : state(seed) {}
+        unsigned long long operator()() {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+// regression gate over two csv runs of the benchmarks.
+// usage: bench_compare BASELINE.csv CURRENT.csv [--threshold 0.10] [--min-ns 1.0]
+// a row regresses when its ns_per_op grew by more than the threshold; rows faster than
+// min-ns in the baseline are too noisy to judge and only reported.
+// exit status: 0 no regression, 1 regression, 2 bad input.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef std::map<std::string, double> run;
+
+std::vector<std::string> split(const std::string &line) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) fields.push_back(field);
+    return fields;
+}
+
+/**
+ * key: suite,impl,op,elem_bytes,n,threads -> ns_per_op
+ */
+bool load(const char *path, run &rows) {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line)) return false;
+    std::vector<std::string> header = split(line);
+    const char *key_columns[] = {"suite", "impl", "op", "elem_bytes", "n", "threads"};
+    int key_index[6], value_index = -1;
+    for (int k = 0; k < 6; k++) {
+        key_index[k] = -1;
+        for (size_t i = 0; i < header.size(); i++) if (header[i] == key_columns[k]) key_index[k] = i;
+        if (key_index[k] < 0) return false;
+    }
+    for (size_t i = 0; i < header.size(); i++) if (header[i] == "ns_per_op") value_index = i;
+    if (value_index < 0) return false;
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields = split(line);
+        if ((int) fields.size() != (int) header.size()) continue;
+        std::string key = fields[key_index[0]];
+        for (int k = 1; k < 6; k++) key += "," + fields[key_index[k]];
+        rows[key] = atof(fields[value_index].c_str());
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s BASELINE.csv CURRENT.csv [--threshold 0.10] [--min-ns 1.0]\n", argv[0]);
+        return 2;
+    }
+    double threshold = 0.10, min_ns = 1.0;
+    for (int i = 3; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--threshold")) threshold = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--min-ns")) min_ns = atof(argv[++i]);
+    }
+    run base, cur;
+    if (!load(argv[1], base) || !load(argv[2], cur)) {
+        fprintf(stderr, "can not read the csv files\n");
+        return 2;
+    }
+    int regressions = 0, improvements = 0, missing = 0;
+    printf("%-70s %12s %12s %8s\n", "case", "base ns/op", "ns/op", "change");
+    for (run::const_iterator it = base.begin(); it != base.end(); ++it) {
+        run::const_iterator found = cur.find(it->first);
+        if (found == cur.end()) {
+            missing++;
+            continue;
+        }
+        double change = it->second > 0 ? found->second / it->second - 1 : 0;
+        const char *mark = "";
+        if (it->second >= min_ns && change > threshold) mark = "  REGRESSION", regressions++;
+        else if (it->second >= min_ns && change < -threshold) mark = "  faster", improvements++;
+        printf("%-70s %12.3f %12.3f %+7.1f%%%s\n", it->first.c_str(), it->second, found->second, change * 100, mark);
+    }
+    printf("\n%d regressions, %d improvements beyond %.0f%%, %d baseline cases missing\n", regressions, improvements,
+           threshold * 100, missing);
+    return regressions > 0 ? 1 : 0;
+}
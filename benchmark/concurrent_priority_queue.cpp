@@ -0,0 +1,74 @@
+// scaling of sjtu::concurrent_priority_queue against one sjtu::priority_queue behind a global mutex
+// usage: concurrent_priority_queue [--max-n TOTAL_OPS] [--threads MAX_THREADS] [--format csv|json] [--out FILE]
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "priority_queue.hpp"
+#include "concurrent_priority_queue.hpp"
+
+class locked_queue {
+private:
+    std::mutex lock;
+    sjtu::priority_queue<long long> pq;
+public:
+    void push(const long long &x) {
+        std::lock_guard<std::mutex> guard(lock);
+        pq.push(x);
+    }
+    bool try_pop(long long &out) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (pq.empty()) return false;
+        out = pq.top();
+        pq.pop();
+        return true;
+    }
+};
+
+template<class Queue>
+double run(Queue &q, int threads, long long ops) {
+    for (long long i = 0; i < 1024 * threads; i++) q.push(i * 2654435761ll % 1000003);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&q, t, threads, ops]() {
+            unsigned long long seed = t * 0x9e3779b97f4a7c15ull + 1;
+            long long sink;
+            for (long long i = t; i < ops; i += threads) {
+                seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+                if (seed & 1) q.push((long long) (seed >> 20));
+                else q.try_pop(sink);
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    bench::options opt = bench::parse(argc, argv);
+    long long ops = opt.max_n == bench::options().max_n ? 4000000 : opt.max_n;
+    int max_threads = 64;
+    for (int i = 1; i + 1 < argc; i++) if (!strcmp(argv[i], "--threads")) max_threads = atoi(argv[i + 1]);
+    bench::reporter out(opt);
+    for (int threads = 1; threads <= max_threads; threads <<= 1) {
+        {
+            locked_queue q;
+            out.record("concurrent_priority_queue", "global_mutex", "push_pop", 8, ops, threads, run(q, threads, ops), ops);
+        }
+        {
+            sjtu::concurrent_priority_queue<long long> q(4 * threads);
+            out.record("concurrent_priority_queue", "multiqueue", "push_pop", 8, ops, threads, run(q, threads, ops), ops);
+        }
+        {
+            sjtu::concurrent_priority_queue<long long> q(4 * threads, true);
+            out.record("concurrent_priority_queue", "multiqueue_strict", "push_pop", 8, ops, threads,
+                       run(q, threads, ops), ops);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+// scaling of sjtu::concurrent_vector appends against one sjtu::vector behind a global mutex
+// usage: concurrent_vector [--max-n TOTAL_PUSHES] [--threads MAX_THREADS] [--format csv|json] [--out FILE]
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "vector.hpp"
+#include "concurrent_vector.hpp"
+
+struct record {
+    long long timestamp;
+    int source;
+    int length;
+};
+
+class locked_vector {
+private:
+    std::mutex lock;
+    sjtu::vector<record> v;
+public:
+    void push_back(const record &r) {
+        std::lock_guard<std::mutex> guard(lock);
+        v.push_back(r);
+    }
+};
+
+/**
+ * every thread appends its share of pushes, one at a time or batch at a time
+ */
+template<class Push>
+double run(int threads, long long pushes, Push push) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([t, threads, pushes, &push]() {
+            for (long long i = t; i < pushes; i += threads) push(record{i, t, (int) (i & 1023)});
+        });
+    }
+    for (auto &w : workers) w.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    bench::options opt = bench::parse(argc, argv);
+    long long pushes = opt.max_n == bench::options().max_n ? 4000000 : opt.max_n;
+    int max_threads = 64;
+    for (int i = 1; i + 1 < argc; i++) if (!strcmp(argv[i], "--threads")) max_threads = atoi(argv[i + 1]);
+    bench::reporter out(opt);
+    const int bytes = sizeof(record);
+    for (int threads = 1; threads <= max_threads; threads <<= 1) {
+        {
+            locked_vector v;
+            out.record("concurrent_vector", "global_mutex", "push_back", bytes, pushes, threads,
+                       run(threads, pushes, [&](const record &r) { v.push_back(r); }), pushes);
+        }
+        {
+            sjtu::concurrent_vector<record> v;
+            out.record("concurrent_vector", "concurrent_vector", "push_back", bytes, pushes, threads,
+                       run(threads, pushes, [&](const record &r) { v.push_back(r); }), pushes);
+        }
+        {
+            // each thread claims 64 slots at a time and fills them in place
+            sjtu::concurrent_vector<record> v;
+            out.record("concurrent_vector", "concurrent_vector", "grow_by_64", bytes, pushes, threads,
+                       run(threads, pushes / 64, [&](const record &r) {
+                           size_t first = v.grow_by(64);
+                           for (size_t j = 0; j < 64; j++) v[first + j] = r;
+                       }), pushes / 64 * 64);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,433 @@
+// sjtu containers against their std counterparts.
+// usage: containers [--max-n N] [--min-n N] [--min-time SECONDS] [--format csv|json] [--out FILE] [--filter SUITE]
+// suites: vector, list, linked_hashmap, priority_queue; element sizes 4, 16 and 64 bytes;
+// columns compares one-field scans over a vector of records and a soa_vector;
+// bulk runs the vector kernels of bulk.hpp against loops over operator[];
+// fifo uses sjtu::list, sjtu::ring_buffer and std::deque as queues;
+// linked_hashmap also runs sjtu::flat_map, built with one bulk insert (insert_bulk);
+// n goes through the powers of ten from min-n to max-n.
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+#include "vector.hpp"
+#include "stable_vector.hpp"
+#include "soa_vector.hpp"
+#include "bulk.hpp"
+#include "flat_map.hpp"
+#include "list.hpp"
+#include "ring_buffer.hpp"
+#include "linked_hashmap.hpp"
+#include "seeded_hash.hpp"
+#include "priority_queue.hpp"
+
+template<int Bytes>
+struct blob {
+    int key;
+    char pad[Bytes - sizeof(int)];
+
+    blob() : key(0) {}
+    blob(int k) : key(k) {}
+    bool operator<(const blob &rhs) const { return key < rhs.key; }
+    bool operator==(const blob &rhs) const { return key == rhs.key; }
+};
+
+inline int key_of(int x) { return x; }
+
+template<int Bytes>
+inline int key_of(const blob<Bytes> &x) { return x.key; }
+
+/**
+ * vector::insert and vector::erase in the middle are O(n), so those ops stop here
+ */
+const long long quadratic_cap = 100000;
+
+struct context {
+    bench::options opt;
+    bench::reporter &out;
+    std::vector<int> keys;  // random keys, the same for every implementation
+    std::vector<int> order;  // random positions in [0, n)
+
+    bool wanted(const char *suite) const {
+        return opt.filter == nullptr || strstr(suite, opt.filter) != nullptr;
+    }
+
+    void prepare(long long n) {
+        bench::rng r;
+        keys.resize(n);
+        order.resize(n);
+        for (long long i = 0; i < n; i++) keys[i] = (int) (r() >> 33), order[i] = (int) (r() % n);
+    }
+
+    template<class Body>
+    void run(const char *suite, const std::string &impl, const char *op, int bytes, long long n, Body body) {
+        out.record(suite, impl, op, bytes, n, 1, bench::measure(opt.min_seconds, body), n);
+    }
+
+    template<class Setup, class Body>
+    void run(const char *suite, const std::string &impl, const char *op, int bytes, long long n, Setup setup,
+             Body body) {
+        out.record(suite, impl, op, bytes, n, 1, bench::measure(opt.min_seconds, setup, body), n);
+    }
+};
+
+template<class T, class Vec, class Sort>
+void vector_suite(context &c, const std::string &impl, long long n, Sort sort_range) {
+    const int bytes = sizeof(T);
+    c.run("vector", impl, "push_back", bytes, n, [&]() {
+        Vec v;
+        for (long long i = 0; i < n; i++) v.push_back(T(c.keys[i]));
+        bench::keep(v);
+    });
+    Vec filled;
+    for (long long i = 0; i < n; i++) filled.push_back(T(c.keys[i]));
+    c.run("vector", impl, "iterate", bytes, n, [&]() {
+        long long sum = 0;
+        for (auto it = filled.begin(); it != filled.end(); ++it) sum += key_of(*it);
+        bench::keep(sum);
+    });
+    c.run("vector", impl, "lookup", bytes, n, [&]() {
+        long long sum = 0;
+        for (long long i = 0; i < n; i++) sum += key_of(filled[c.order[i]]);
+        bench::keep(sum);
+    });
+    c.run("vector", impl, "copy", bytes, n, [&]() {
+        Vec v(filled);
+        bench::keep(v);
+    });
+    Vec work;
+    c.run("vector", impl, "sort", bytes, n, [&]() { work = filled; }, [&]() { sort_range(work); });
+    if (n > quadratic_cap) return;
+    c.run("vector", impl, "insert_middle", bytes, n, [&]() {
+        Vec v;
+        for (long long i = 0; i < n; i++) v.insert(v.begin() + (int) (v.size() / 2), T(c.keys[i]));
+        bench::keep(v);
+    });
+    c.run("vector", impl, "erase_middle", bytes, n, [&]() { work = filled; }, [&]() {
+        while (!work.empty()) work.erase(work.begin() + (int) (work.size() / 2));
+    });
+}
+
+template<class T, class List>
+void list_suite(context &c, const std::string &impl, long long n) {
+    const int bytes = sizeof(T);
+    c.run("list", impl, "push_back", bytes, n, [&]() {
+        List l;
+        for (long long i = 0; i < n; i++) l.push_back(T(c.keys[i]));
+        bench::keep(l);
+    });
+    c.run("list", impl, "push_front", bytes, n, [&]() {
+        List l;
+        for (long long i = 0; i < n; i++) l.push_front(T(c.keys[i]));
+        bench::keep(l);
+    });
+    c.run("list", impl, "insert", bytes, n, [&]() {
+        List l;
+        auto it = l.end();
+        for (long long i = 0; i < n; i++) it = l.insert(it, T(c.keys[i]));
+        bench::keep(l);
+    });
+    List filled, work;
+    for (long long i = 0; i < n; i++) filled.push_back(T(c.keys[i]));
+    c.run("list", impl, "iterate", bytes, n, [&]() {
+        long long sum = 0;
+        for (auto it = filled.begin(); it != filled.end(); ++it) sum += key_of(*it);
+        bench::keep(sum);
+    });
+    c.run("list", impl, "copy", bytes, n, [&]() {
+        List l(filled);
+        bench::keep(l);
+    });
+    c.run("list", impl, "erase", bytes, n, [&]() { work = filled; }, [&]() {
+        while (!work.empty()) work.pop_front();
+    });
+    c.run("list", impl, "sort", bytes, n, [&]() { work = filled; }, [&]() { work.sort(); });
+}
+
+template<class T, class Map, class Make>
+void hashmap_suite(context &c, const std::string &impl, long long n, Make make) {
+    const int bytes = sizeof(T);
+    c.run("linked_hashmap", impl, "insert", bytes, n, [&]() {
+        Map m;
+        for (long long i = 0; i < n; i++) m.insert(make(c.keys[i], T(i)));
+        bench::keep(m);
+    });
+    Map filled;
+    for (long long i = 0; i < n; i++) filled.insert(make(c.keys[i], T(i)));
+    c.run("linked_hashmap", impl, "lookup_hit", bytes, n, [&]() {
+        long long sum = 0;
+        for (long long i = 0; i < n; i++) sum += key_of((*filled.find(c.keys[c.order[i]])).second);
+        bench::keep(sum);
+    });
+    c.run("linked_hashmap", impl, "lookup_miss", bytes, n, [&]() {
+        long long sum = 0;
+        for (long long i = 0; i < n; i++) sum += filled.count(-1 - c.keys[i]);
+        bench::keep(sum);
+    });
+    c.run("linked_hashmap", impl, "iterate", bytes, n, [&]() {
+        long long sum = 0;
+        for (auto it = filled.begin(); it != filled.end(); ++it) sum += key_of((*it).second);
+        bench::keep(sum);
+    });
+    c.run("linked_hashmap", impl, "copy", bytes, n, [&]() {
+        Map m(filled);
+        bench::keep(m);
+    });
+    Map work;
+    c.run("linked_hashmap", impl, "erase", bytes, n, [&]() { work = filled; }, [&]() {
+        for (long long i = 0; i < n; i++) {
+            auto it = work.find(c.keys[i]);
+            if (it != work.end()) work.erase(it);
+        }
+    });
+}
+
+/**
+ * queue traffic: fill then drain, a queue kept at a short depth, and a scan.
+ */
+template<class T, class Queue>
+void fifo_suite(context &c, const std::string &impl, long long n) {
+    const int bytes = sizeof(T);
+    c.run("fifo", impl, "fill_drain", bytes, n, [&]() {
+        Queue q;
+        for (long long i = 0; i < n; i++) q.push_back(T(c.keys[i]));
+        long long sum = 0;
+        while (!q.empty()) sum += key_of(q.front()), q.pop_front();
+        bench::keep(sum);
+    });
+    c.run("fifo", impl, "steady", bytes, n, [&]() {
+        Queue q;
+        long long sum = 0;
+        for (long long i = 0; i < n; i++) {
+            q.push_back(T(c.keys[i]));
+            if (i >= 64) sum += key_of(q.front()), q.pop_front();
+        }
+        bench::keep(sum);
+    });
+    Queue filled;
+    for (long long i = 0; i < n; i++) filled.push_back(T(c.keys[i]));
+    c.run("fifo", impl, "iterate", bytes, n, [&]() {
+        long long sum = 0;
+        for (auto it = filled.begin(); it != filled.end(); ++it) sum += key_of(*it);
+        bench::keep(sum);
+    });
+}
+
+/**
+ * flat_map has no O(1) insert: it is built with one insert(first, last), and the
+ * one-at-a-time insert and erase ops only run up to quadratic_cap.
+ */
+template<class T>
+void flat_map_suite(context &c, long long n) {
+    typedef sjtu::flat_map<int, T> Map;
+    const int bytes = sizeof(T);
+    const std::string impl = "sjtu::flat_map";
+    std::vector<std::pair<int, T>> entries;
+    for (long long i = 0; i < n; i++) entries.push_back(std::make_pair(c.keys[i], T(i)));
+    if (n <= quadratic_cap) {
+        c.run("linked_hashmap", impl, "insert", bytes, n, [&]() {
+            Map m;
+            for (long long i = 0; i < n; i++) m.insert(typename Map::value_type(c.keys[i], T(i)));
+            bench::keep(m);
+        });
+    }
+    c.run("linked_hashmap", impl, "insert_bulk", bytes, n, [&]() {
+        Map m(entries.begin(), entries.end());
+        bench::keep(m);
+    });
+    Map filled(entries.begin(), entries.end());
+    c.run("linked_hashmap", impl, "lookup_hit", bytes, n, [&]() {
+        long long sum = 0;
+        for (long long i = 0; i < n; i++) sum += key_of(filled.find(c.keys[c.order[i]]).value());
+        bench::keep(sum);
+    });
+    c.run("linked_hashmap", impl, "lookup_miss", bytes, n, [&]() {
+        long long sum = 0;
+        for (long long i = 0; i < n; i++) sum += filled.count(-1 - c.keys[i]);
+        bench::keep(sum);
+    });
+    c.run("linked_hashmap", impl, "iterate", bytes, n, [&]() {
+        long long sum = 0;
+        for (typename Map::iterator it = filled.begin(); it != filled.end(); ++it) sum += key_of(it.value());
+        bench::keep(sum);
+    });
+    c.run("linked_hashmap", impl, "copy", bytes, n, [&]() {
+        Map m(filled);
+        bench::keep(m);
+    });
+    if (n > quadratic_cap) return;
+    Map work;
+    c.run("linked_hashmap", impl, "erase", bytes, n, [&]() { work = filled; }, [&]() {
+        for (long long i = 0; i < n; i++) work.erase(c.keys[i]);
+    });
+}
+
+template<class T, class PQ>
+void priority_queue_suite(context &c, const std::string &impl, long long n) {
+    const int bytes = sizeof(T);
+    c.run("priority_queue", impl, "push", bytes, n, [&]() {
+        PQ q;
+        for (long long i = 0; i < n; i++) q.push(T(c.keys[i]));
+        bench::keep(q);
+    });
+    PQ filled, work;
+    for (long long i = 0; i < n; i++) filled.push(T(c.keys[i]));
+    c.run("priority_queue", impl, "pop", bytes, n, [&]() { work = filled; }, [&]() {
+        while (!work.empty()) work.pop();
+    });
+    c.run("priority_queue", impl, "copy", bytes, n, [&]() {
+        PQ q(filled);
+        bench::keep(q);
+    });
+}
+
+struct record {
+    long long timestamp;
+    int id;
+    double price;
+    int qty;
+};
+
+typedef sjtu::soa_vector<long long, int, double, int> record_columns;
+
+void columns_suite(context &c, long long n) {
+    const int bytes = sizeof(record);
+    c.run("columns", "sjtu::vector", "push_back", bytes, n, [&]() {
+        sjtu::vector<record> v;
+        for (long long i = 0; i < n; i++) v.push_back(record{i, c.keys[i], c.keys[i] * 0.01, c.order[i] % 100});
+        bench::keep(v);
+    });
+    c.run("columns", "sjtu::soa_vector", "push_back", bytes, n, [&]() {
+        record_columns v;
+        for (long long i = 0; i < n; i++) v.push_back(i, c.keys[i], c.keys[i] * 0.01, c.order[i] % 100);
+        bench::keep(v);
+    });
+    sjtu::vector<record> rows;
+    record_columns columns;
+    for (long long i = 0; i < n; i++) {
+        rows.push_back(record{i, c.keys[i], c.keys[i] * 0.01, c.order[i] % 100});
+        columns.push_back(i, c.keys[i], c.keys[i] * 0.01, c.order[i] % 100);
+    }
+    c.run("columns", "sjtu::vector", "scan", bytes, n, [&]() {
+        double sum = 0;
+        for (auto it = rows.begin(); it != rows.end(); ++it) sum += (*it).price;
+        bench::keep(sum);
+    });
+    c.run("columns", "sjtu::soa_vector", "scan", bytes, n, [&]() {
+        double sum = 0;
+        for (double price : columns.column<2>()) sum += price;
+        bench::keep(sum);
+    });
+    c.run("columns", "sjtu::vector", "filter", bytes, n, [&]() {
+        double sum = 0;
+        for (auto it = rows.begin(); it != rows.end(); ++it) sum += (*it).qty > 90 ? (*it).price : 0;
+        bench::keep(sum);
+    });
+    c.run("columns", "sjtu::soa_vector", "filter", bytes, n, [&]() {
+        const double *price = columns.column<2>().data();
+        const int *qty = columns.column<3>().data();
+        double sum = 0;
+        for (size_t i = 0; i < columns.size(); i++) sum += qty[i] > 90 ? price[i] : 0;
+        bench::keep(sum);
+    });
+}
+
+template<class T>
+void bulk_suite(context &c, long long n) {
+    const int bytes = sizeof(T);
+    sjtu::vector<T> v;
+    for (long long i = 0; i < n; i++) v.push_back((T) (c.keys[i] % 1000));
+    const T missing = (T) -1;
+    c.run("bulk", "loop", "find", bytes, n, [&]() {
+        size_t i = 0;
+        while (i < v.size() && v[i] != missing) i++;
+        bench::keep(i);
+    });
+    c.run("bulk", "sjtu::bulk", "find", bytes, n, [&]() { bench::keep(sjtu::bulk::find(v, missing)); });
+    c.run("bulk", "loop", "count", bytes, n, [&]() {
+        size_t same = 0;
+        for (size_t i = 0; i < v.size(); i++) same += v[i] == (T) 7;
+        bench::keep(same);
+    });
+    c.run("bulk", "sjtu::bulk", "count", bytes, n, [&]() { bench::keep(sjtu::bulk::count(v, (T) 7)); });
+    c.run("bulk", "loop", "min", bytes, n, [&]() {
+        T lo = v[0];
+        for (size_t i = 1; i < v.size(); i++) lo = v[i] < lo ? v[i] : lo;
+        bench::keep(lo);
+    });
+    c.run("bulk", "sjtu::bulk", "min", bytes, n, [&]() { bench::keep(sjtu::bulk::min(v)); });
+    c.run("bulk", "loop", "sum", bytes, n, [&]() {
+        sjtu::bulk::sum_type<T> total = 0;
+        for (size_t i = 0; i < v.size(); i++) total += v[i];
+        bench::keep(total);
+    });
+    c.run("bulk", "sjtu::bulk", "sum", bytes, n, [&]() { bench::keep(sjtu::bulk::sum(v)); });
+    c.run("bulk", "loop", "fill", bytes, n, [&]() {
+        for (size_t i = 0; i < v.size(); i++) v[i] = (T) 3;
+        bench::keep(v);
+    });
+    c.run("bulk", "sjtu::bulk", "fill", bytes, n, [&]() {
+        sjtu::bulk::fill(v, (T) 3);
+        bench::keep(v);
+    });
+}
+
+template<class T>
+void run_all(context &c, long long n) {
+    if (c.wanted("vector")) {
+        vector_suite<T, sjtu::vector<T>>(c, "sjtu::vector", n, [](sjtu::vector<T> &v) { sjtu::sort(v.begin(), v.end()); });
+        vector_suite<T, sjtu::stable_vector<T>>(c, "sjtu::stable_vector", n, [](sjtu::stable_vector<T> &v) {
+            std::sort(v.begin(), v.end());
+        });
+        vector_suite<T, std::vector<T>>(c, "std::vector", n, [](std::vector<T> &v) { std::sort(v.begin(), v.end()); });
+    }
+    if (c.wanted("list")) {
+        list_suite<T, sjtu::list<T>>(c, "sjtu::list", n);
+        list_suite<T, std::list<T>>(c, "std::list", n);
+    }
+    if (c.wanted("fifo")) {
+        fifo_suite<T, sjtu::list<T>>(c, "sjtu::list", n);
+        fifo_suite<T, sjtu::ring_buffer<T>>(c, "sjtu::ring_buffer", n);
+        fifo_suite<T, std::deque<T>>(c, "std::deque", n);
+    }
+    if (c.wanted("linked_hashmap")) {
+        hashmap_suite<T, sjtu::linked_hashmap<int, T>>(c, "sjtu::linked_hashmap", n, [](int k, const T &v) {
+            return typename sjtu::linked_hashmap<int, T>::value_type(k, v);
+        });
+        typedef sjtu::linked_hashmap<int, T, sjtu::seeded_hash<int>> seeded_map;
+        hashmap_suite<T, seeded_map>(c, "sjtu::linked_hashmap+seeded_hash", n, [](int k, const T &v) {
+            return typename seeded_map::value_type(k, v);
+        });
+        hashmap_suite<T, std::unordered_map<int, T>>(c, "std::unordered_map", n, [](int k, const T &v) {
+            return std::pair<const int, T>(k, v);
+        });
+        flat_map_suite<T>(c, n);
+    }
+    if (c.wanted("priority_queue")) {
+        priority_queue_suite<T, sjtu::priority_queue<T>>(c, "sjtu::priority_queue", n);
+        priority_queue_suite<T, std::priority_queue<T>>(c, "std::priority_queue", n);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    bench::options opt = bench::parse(argc, argv);
+    bench::reporter out(opt);
+    context c = {opt, out, {}, {}};
+    for (long long n = opt.min_n; n <= opt.max_n; n *= 10) {
+        c.prepare(n);
+        if (c.wanted("columns")) columns_suite(c, n);
+        if (c.wanted("bulk")) {
+            bulk_suite<int>(c, n);
+            bulk_suite<double>(c, n);
+        }
+        run_all<int>(c, n);
+        run_all<blob<16>>(c, n);
+        run_all<blob<64>>(c, n);
+    }
+    return 0;
+}
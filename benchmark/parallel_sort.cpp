@@ -0,0 +1,39 @@
+// scaling of sjtu::parallel_sort against sequential sjtu::sort
+// usage: parallel_sort [--max-n N] [--threads MAX_THREADS] [--format csv|json] [--out FILE]
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "bench.hpp"
+#include "algorithm.hpp"
+#include "parallel_sort.hpp"
+
+std::vector<long long> make_input(long long n) {
+    std::vector<long long> a(n);
+    unsigned long long seed = 88172645463325252ull;
+    for (long long &x : a) {
+        seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+        x = (long long) (seed >> 1);
+    }
+    return a;
+}
+
+int main(int argc, char *argv[]) {
+    bench::options opt = bench::parse(argc, argv);
+    long long n = opt.max_n == bench::options().max_n ? 50000000 : opt.max_n;
+    int max_threads = 64;
+    for (int i = 1; i + 1 < argc; i++) if (!strcmp(argv[i], "--threads")) max_threads = atoi(argv[i + 1]);
+    bench::reporter out(opt);
+    auto cmp = [](const long long &x, const long long &y) { return x < y; };
+    std::vector<long long> a;
+    double sec = bench::measure(0, [&]() { a = make_input(n); }, [&]() { sjtu::sort(a.begin(), a.end(), cmp); });
+    out.record("parallel_sort", "sort", "sort", 8, n, 1, sec, n);
+    for (int threads = 1; threads <= max_threads; threads <<= 1) {
+        for (int stable = 0; stable <= 1; stable++) {
+            sec = bench::measure(0, [&]() { a = make_input(n); },
+                                 [&]() { sjtu::parallel_sort(a.begin(), a.end(), cmp, threads, stable); });
+            out.record("parallel_sort", stable ? "parallel_sort_stable" : "parallel_sort", "sort", 8, n, threads, sec, n);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+// sjtu::spsc_queue and sjtu::mpmc_queue against a sjtu::list behind a mutex, as a thread handoff
+// usage: queues [--max-n MESSAGES] [--threads MAX_PAIRS] [--format csv|json] [--out FILE]
+// throughput: producers and consumers in pairs pass MESSAGES messages, one at a time or 32 at a time;
+// latency: two threads bounce one message through a pair of queues, ns_per_op is a round trip.
+// waiting threads yield, so on fewer cores than threads the numbers include scheduling.
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "list.hpp"
+#include "spsc_queue.hpp"
+#include "mpmc_queue.hpp"
+
+struct message {
+    long long id;
+    int source;
+    int length;
+};
+
+const size_t ring = 1024;
+const size_t batch = 32;
+
+class locked_list {
+private:
+    std::mutex lock;
+    sjtu::list<message> l;
+public:
+    bool try_push(const message &m) {
+        std::lock_guard<std::mutex> guard(lock);
+        l.push_back(m);
+        return true;
+    }
+
+    bool try_pop(message &out) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (l.empty()) return false;
+        out = l.front();
+        l.pop_front();
+        return true;
+    }
+};
+
+/**
+ * pairs producers push their share of the messages with push(first, n), pairs consumers
+ * pop with pop(out, max) until all of them arrived; both return how many they moved.
+ */
+template<class Push, class Pop>
+double throughput(int pairs, long long messages, size_t step, Push push, Pop pop) {
+    std::atomic<long long> received(0);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < pairs; t++) {
+        workers.emplace_back([&, t]() {
+            message buf[batch];
+            for (long long i = t; i < messages;) {
+                size_t n = 0;
+                for (long long j = i; n < step && j < messages; j += pairs) buf[n++] = message{j, t, (int) (j & 1023)};
+                for (size_t done = 0; done < n;) {
+                    size_t k = push(buf + done, n - done);
+                    if (k == 0) std::this_thread::yield();
+                    done += k;
+                }
+                i += (long long) n * pairs;
+            }
+        });
+        workers.emplace_back([&]() {
+            message buf[batch];
+            long long sum = 0;
+            while (received.load(std::memory_order_relaxed) < messages) {
+                size_t k = pop(buf, step);
+                if (k == 0) std::this_thread::yield();
+                for (size_t i = 0; i < k; i++) sum += buf[i].length;
+                received.fetch_add((long long) k, std::memory_order_relaxed);
+            }
+            bench::keep(sum);
+        });
+    }
+    for (auto &w : workers) w.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * a message goes there and back trips times, through the queues there and back.
+ */
+template<class Queue>
+double latency(Queue &there, Queue &back, long long trips) {
+    std::thread echo([&]() {
+        message m;
+        for (long long i = 0; i < trips; i++) {
+            while (!there.try_pop(m)) std::this_thread::yield();
+            while (!back.try_push(m)) std::this_thread::yield();
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    message m{0, 0, 0};
+    for (long long i = 0; i < trips; i++) {
+        m.id = i;
+        while (!there.try_push(m)) std::this_thread::yield();
+        while (!back.try_pop(m)) std::this_thread::yield();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    echo.join();
+    return seconds;
+}
+
+template<class Queue>
+size_t push_one(Queue &q, message *first, size_t) {
+    return q.try_push(*first) ? 1 : 0;
+}
+
+template<class Queue>
+size_t pop_one(Queue &q, message *out, size_t) {
+    return q.try_pop(*out) ? 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    bench::options opt = bench::parse(argc, argv);
+    long long messages = opt.max_n == bench::options().max_n ? 4000000 : opt.max_n;
+    int max_pairs = 8;
+    for (int i = 1; i + 1 < argc; i++) if (!strcmp(argv[i], "--threads")) max_pairs = atoi(argv[i + 1]);
+    bench::reporter out(opt);
+    const int bytes = sizeof(message);
+    auto report = [&](const char *impl, const char *op, int threads, long long n, double seconds) {
+        out.record("queues", impl, op, bytes, n, threads, seconds, n);
+    };
+
+    {
+        locked_list q;
+        report("mutex_list", "spsc", 2, messages, throughput(1, messages, 1,
+               [&](message *m, size_t n) { return push_one(q, m, n); }, [&](message *m, size_t n) { return pop_one(q, m, n); }));
+    }
+    {
+        sjtu::spsc_queue<message> q(ring);
+        report("spsc_queue", "spsc", 2, messages, throughput(1, messages, 1,
+               [&](message *m, size_t n) { return push_one(q, m, n); }, [&](message *m, size_t n) { return pop_one(q, m, n); }));
+    }
+    {
+        sjtu::spsc_queue<message> q(ring);
+        report("spsc_queue", "spsc_batch", 2, messages, throughput(1, messages, batch,
+               [&](message *m, size_t n) { return q.push_batch(m, n); }, [&](message *m, size_t n) { return q.pop_batch(m, n); }));
+    }
+    for (int pairs = 1; pairs <= max_pairs; pairs <<= 1) {
+        {
+            locked_list q;
+            report("mutex_list", "mpmc", 2 * pairs, messages, throughput(pairs, messages, 1,
+                   [&](message *m, size_t n) { return push_one(q, m, n); }, [&](message *m, size_t n) { return pop_one(q, m, n); }));
+        }
+        {
+            sjtu::mpmc_queue<message> q(ring);
+            report("mpmc_queue", "mpmc", 2 * pairs, messages, throughput(pairs, messages, 1,
+                   [&](message *m, size_t n) { return push_one(q, m, n); }, [&](message *m, size_t n) { return pop_one(q, m, n); }));
+        }
+        {
+            sjtu::mpmc_queue<message> q(ring);
+            report("mpmc_queue", "mpmc_batch", 2 * pairs, messages, throughput(pairs, messages, batch,
+                   [&](message *m, size_t n) { return q.push_batch(m, n); }, [&](message *m, size_t n) { return q.pop_batch(m, n); }));
+        }
+    }
+
+    long long trips = messages / 40;
+    {
+        locked_list there, back;
+        report("mutex_list", "round_trip", 2, trips, latency(there, back, trips));
+    }
+    {
+        sjtu::spsc_queue<message> there(ring), back(ring);
+        report("spsc_queue", "round_trip", 2, trips, latency(there, back, trips));
+    }
+    {
+        sjtu::mpmc_queue<message> there(ring), back(ring);
+        report("mpmc_queue", "round_trip", 2, trips, latency(there, back, trips));
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+# cmake -DEXE=<driver> -DEXPECTED=<data/case.txt or empty> -DWORKDIR=<scratch dir> -P run_data_test.cmake
+# line endings and trailing blanks are not significant, the expected outputs mix both styles.
+
+file(REMOVE_RECURSE ${WORKDIR})
+file(MAKE_DIRECTORY ${WORKDIR})
+execute_process(COMMAND ${EXE} WORKING_DIRECTORY ${WORKDIR}
+        OUTPUT_FILE ${WORKDIR}/stdout.txt RESULT_VARIABLE status)
+if (NOT status EQUAL 0)
+    message(FATAL_ERROR "${EXE} exited with ${status}")
+endif ()
+
+set(actual ${WORKDIR}/stdout.txt)
+foreach (redirected out.txt test.out)
+    if (EXISTS ${WORKDIR}/${redirected})
+        set(actual ${WORKDIR}/${redirected})
+    endif ()
+endforeach ()
+
+function(normalize path out)
+    file(READ ${path} text)
+    string(REPLACE "\r" "" text "${text}")
+    string(REGEX REPLACE "[ \t]+\n" "\n" text "${text}")
+    string(REGEX REPLACE "[ \t\n]+$" "" text "${text}")
+    set(${out} "${text}" PARENT_SCOPE)
+endfunction()
+
+normalize(${actual} got)
+if (NOT EXPECTED)
+    if (got MATCHES "FAILED")
+        message(FATAL_ERROR "${EXE} reported a failure, see ${actual}")
+    endif ()
+    return()
+endif ()
+
+normalize(${EXPECTED} want)
+if (NOT got STREQUAL want)
+    string(REPLACE "\n" ";" got_lines "${got}")
+    string(REPLACE "\n" ";" want_lines "${want}")
+    list(LENGTH got_lines got_count)
+    list(LENGTH want_lines want_count)
+    set(line 0)
+    while (line LESS got_count AND line LESS want_count)
+        list(GET got_lines ${line} g)
+        list(GET want_lines ${line} w)
+        if (NOT g STREQUAL w)
+            break()
+        endif ()
+        math(EXPR line "${line} + 1")
+    endwhile ()
+    math(EXPR shown "${line} + 1")
+    message(FATAL_ERROR "output differs from ${EXPECTED} at line ${shown} (${got_count} lines, expected ${want_count}), see ${actual}")
+endif ()
@@ -0,0 +1,69 @@
+# helpers shared by the container directories and the benchmarks
+
+set(SJTU_RUN_DATA_TEST "${CMAKE_CURRENT_LIST_DIR}/run_data_test.cmake")
+
+# header-only target sjtu_<name> (alias sjtu::<name>) over the headers of the calling directory
+function(sjtu_add_container name)
+    add_library(sjtu_${name} INTERFACE)
+    add_library(sjtu::${name} ALIAS sjtu_${name})
+    target_include_directories(sjtu_${name} INTERFACE ${CMAKE_CURRENT_SOURCE_DIR})
+    target_link_libraries(sjtu_${name} INTERFACE Threads::Threads)
+endfunction()
+
+# every data/<case>.cpp becomes the executable <name>_<case> and the test <name>/<case>.
+# the test runs the driver in a scratch directory and diffs what it printed (stdout, or
+# the out.txt / test.out some drivers redirect to) against data/<case>.txt; drivers
+# without an expected output must exit 0 and must not print FAILED.
+# the drivers build with -Wall -Wextra, so the headers they include do too, except the
+# cases listed after LEGACY: the original course drivers, which build with -w.
+function(sjtu_add_data_tests name)
+    if (NOT SJTU_BUILD_TESTS)
+        return()
+    endif ()
+    cmake_parse_arguments(PARSE_ARGV 1 arg "" "" "LEGACY")
+    file(GLOB drivers CONFIGURE_DEPENDS ${CMAKE_CURRENT_SOURCE_DIR}/data/*.cpp)
+    foreach (driver ${drivers})
+        get_filename_component(case ${driver} NAME_WE)
+        set(exe ${name}_${case})
+        add_executable(${exe} ${driver})
+        target_link_libraries(${exe} PRIVATE sjtu_${name})
+        if (case IN_LIST arg_LEGACY)
+            target_compile_options(${exe} PRIVATE -w)
+        else ()
+            target_compile_options(${exe} PRIVATE -Wall -Wextra)
+        endif ()
+        set(expected ${CMAKE_CURRENT_SOURCE_DIR}/data/${case}.txt)
+        if (NOT EXISTS ${expected})
+            set(expected "")
+        endif ()
+        add_test(NAME ${name}/${case}
+                COMMAND ${CMAKE_COMMAND} -DEXE=$<TARGET_FILE:${exe}> -DEXPECTED=${expected}
+                -DWORKDIR=${CMAKE_CURRENT_BINARY_DIR}/run/${case} -P ${SJTU_RUN_DATA_TEST})
+        set_tests_properties(${name}/${case} PROPERTIES TIMEOUT 900 LABELS ${name})
+    endforeach ()
+endfunction()
+
+# benchmark executable: -O3, plus -march=native, LTO and PGO as configured
+function(sjtu_add_benchmark exe source)
+    add_executable(${exe} ${source})
+    target_link_libraries(${exe} PRIVATE ${ARGN})
+    target_compile_options(${exe} PRIVATE -O3 $<$<BOOL:${SJTU_NATIVE}>:-march=native>)
+    if (SJTU_LTO)
+        set_property(TARGET ${exe} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+    endif ()
+    if (SJTU_PGO STREQUAL "GENERATE")
+        target_compile_options(${exe} PRIVATE -fprofile-generate=${SJTU_PGO_DIR})
+        target_link_options(${exe} PRIVATE -fprofile-generate=${SJTU_PGO_DIR})
+    elseif (SJTU_PGO STREQUAL "USE")
+        if (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+            # clang reads one merged profile: llvm-profdata merge -o default.profdata *.profraw
+            set(profile ${SJTU_PGO_DIR}/default.profdata)
+        else ()
+            set(profile ${SJTU_PGO_DIR})
+        endif ()
+        target_compile_options(${exe} PRIVATE -fprofile-use=${profile} -fprofile-correction -Wno-missing-profile)
+        target_link_options(${exe} PRIVATE -fprofile-use=${profile})
+    elseif (NOT SJTU_PGO STREQUAL "OFF")
+        message(FATAL_ERROR "SJTU_PGO must be OFF, GENERATE or USE, not ${SJTU_PGO}")
+    endif ()
+endfunction()
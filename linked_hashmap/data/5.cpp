@@ -0,0 +1,58 @@
+#define SJTU_STATS
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "linked_hashmap.hpp"
+
+struct ConstantHash {
+    size_t operator()(int) const { return 7; }
+};
+
+bool testDegenerateHash() {
+    sjtu::linked_hashmap<int, int, ConstantHash> map;
+    for (int i = 0; i < 100; i++) map.insert(sjtu::linked_hashmap<int, int, ConstantHash>::value_type(i, i));
+    // the chain is newest first and each insert walks all of it before adding a node
+    sjtu::linked_hashmap<int, int, ConstantHash>::statistics s = map.stats();
+    if (s.lookups != 100 || s.probes != 99 * 100 / 2 || s.max_probe != 99) return false;
+    if (s.rehashes != 4 || s.allocations != 1 + 2 * 100 + 4) return false;
+    map.reset_stats();
+    if (map.find(0) == map.end() || map.count(-1) != 0) return false;
+    s = map.stats();
+    return s.lookups == 2 && s.probes == 200 && s.max_probe == 100 && s.rehashes == 0 && s.allocations == 0;
+}
+
+bool testGoodHash() {
+    sjtu::linked_hashmap<int, int> map;
+    for (int i = 0; i < 10000; i++) map[i * 7919] = i;
+    for (int i = 0; i < 10000; i++) if (map.at(i * 7919) != i) return false;
+    sjtu::linked_hashmap<int, int>::statistics s = map.stats();
+    if (s.lookups != 20000 || s.max_probe > 4) return false;
+    if (s.bytes_allocated < 10000 * sizeof(sjtu::linked_hashmap<int, int>::value_type)) return false;
+    sjtu::linked_hashmap<int, int> copy(map);
+    return copy.stats().lookups == 0 && copy.stats().rehashes == 0 && copy.stats().allocations == 1 + 2 * 10000;
+}
+
+bool testConcurrentReaders() {
+    sjtu::linked_hashmap<int, int, ConstantHash> map;
+    for (int i = 0; i < 50; i++) map[i] = i;
+    map.reset_stats();
+    const sjtu::linked_hashmap<int, int, ConstantHash> &c = map;
+    // const lookups from several threads count without losing updates
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&c, t]() {
+            for (int i = 0; i < 20000; i++) c.find((i + t) % 50);
+        });
+    }
+    for (auto &r : readers) r.join();
+    sjtu::linked_hashmap<int, int, ConstantHash>::statistics s = map.stats();
+    return s.lookups == 4 * 20000 && s.max_probe == 50;
+}
+
+int main() {
+    std::cout << (testDegenerateHash() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testGoodHash() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testConcurrentReaders() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <iostream>
+#include "linked_hashmap.hpp"
+
+struct ConstantHash {
+    size_t operator()(int) const { return 7; }
+};
+
+int warnings = 0, worst_key = -1;
+size_t worst_chain = 0;
+
+void onLongChain(const int &key, size_t chain, size_t) {
+    warnings++;
+    if (chain > worst_chain) worst_chain = chain, worst_key = key;
+}
+
+bool testGoodHash() {
+    sjtu::linked_hashmap<int, int> map;
+    map.warn_on_chain_length(8, onLongChain);
+    unsigned seed = 12345;
+    for (int i = 0; i < 50000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        map[(int) (seed >> 1)] = i;
+    }
+    sjtu::linked_hashmap<int, int>::chain_report r = map.report_chains();
+    size_t total = 0, nodes = 0;
+    for (size_t k = 0; k < r.histogram_size; k++) total += r.histogram[k], nodes += k * r.histogram[k];
+    return warnings == 0 && r.elements == map.size() && total == r.buckets && nodes == r.elements &&
+           r.buckets - r.histogram[0] == r.used_buckets && r.max_chain <= 8 && r.collision_score < 1.2 &&
+           r.collision_score > 0.8 && r.mean_chain >= 1 && r.load_factor < 0.62;
+}
+
+bool testDegenerateHash() {
+    sjtu::linked_hashmap<int, int, ConstantHash> map;
+    map.warn_on_chain_length(32, onLongChain);
+    for (int i = 0; i < 1000; i++) map[i] = i;
+    sjtu::linked_hashmap<int, int, ConstantHash>::chain_report r = map.report_chains();
+    // every key is in one chain, which grows past the limit on the 33rd insert
+    return warnings == 1000 - 32 && worst_chain == 1000 && worst_key == 999 && r.used_buckets == 1 &&
+           r.max_chain == 1000 && r.mean_chain == 1000 && r.histogram[r.histogram_size - 1] == 1 &&
+           r.collision_score > 100;
+}
+
+bool testEmpty() {
+    sjtu::linked_hashmap<int, int> map;
+    sjtu::linked_hashmap<int, int>::chain_report r = map.report_chains();
+    return r.elements == 0 && r.max_chain == 0 && r.histogram[0] == r.buckets && r.collision_score == 1;
+}
+
+int main() {
+    std::cout << (testGoodHash() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testDegenerateHash() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testEmpty() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <iostream>
+#include <map>
+#include <string>
+#include "linked_hashmap.hpp"
+#include "seeded_hash.hpp"
+
+bool testSipHashVectors() {
+    // the reference vectors of SipHash-2-4: key 00 01 .. 0f, messages 00 01 .. (len - 1)
+    sjtu::seeded_hash<std::string> hash(0x0706050403020100ull, 0x0f0e0d0c0b0a0908ull);
+    std::string message;
+    if (hash(message) != (size_t) 0x726fdb47dd0e0e31ull) return false;
+    for (int i = 0; i < 15; i++) message += (char) i;
+    if (hash(message) != (size_t) 0xa129ca6149be45e5ull) return false;
+    sjtu::seeded_hash<std::string> other;
+    return other(message) == other(std::string(message)) && other(message) != hash(message);
+}
+
+bool testFreshKeys() {
+    sjtu::seeded_hash<long long> a, b;
+    int same = 0;
+    for (long long i = 0; i < 1000; i++) same += a(i) == b(i);
+    sjtu::seeded_hash<long long> fixed(1, 2), again(1, 2);
+    return same < 2 && fixed(12345) == again(12345);
+}
+
+bool testFlooding() {
+    // multiples of 2^20 fall into a handful of buckets under the identity std::hash<int>
+    sjtu::linked_hashmap<int, int> plain;
+    sjtu::linked_hashmap<int, int, sjtu::seeded_hash<int>> seeded;
+    for (int i = 0; i < 2000; i++) plain[i << 20] = i, seeded[i << 20] = i;
+    for (int i = 0; i < 2000; i++) if (seeded.at(i << 20) != i) return false;
+    return plain.report_chains().collision_score > 50 && seeded.report_chains().collision_score < 1.5 &&
+           seeded.report_chains().max_chain < 10;
+}
+
+bool testStringKeys() {
+    typedef sjtu::linked_hashmap<std::string, int, sjtu::seeded_hash<std::string>> map_type;
+    map_type map(sjtu::seeded_hash<std::string>(7, 11));
+    std::map<std::string, int> ref;
+    unsigned seed = 2333;
+    for (int i = 0; i < 20000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        std::string key = "key" + std::to_string(seed % 5000);
+        if (seed & 1) {
+            map[key] = i, ref[key] = i;
+        } else {
+            map_type::iterator it = map.find(key);
+            if ((it == map.end()) != (ref.count(key) == 0)) return false;
+            if (it != map.end()) map.erase(it), ref.erase(key);
+        }
+    }
+    map_type copy(map);
+    if (copy.size() != ref.size()) return false;
+    for (std::map<std::string, int>::iterator it = ref.begin(); it != ref.end(); ++it) {
+        if (copy.at(it->first) != it->second || map.count(it->first) != 1) return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << (testSipHashVectors() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testFreshKeys() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testFlooding() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testStringKeys() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
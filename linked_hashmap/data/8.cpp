@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "linked_hashmap.hpp"
+#include "seeded_hash.hpp"
+
+typedef sjtu::linked_hashmap<int, std::string> map_type;
+
+static_assert(std::is_nothrow_move_constructible<map_type>::value, "linked_hashmap move may not throw");
+static_assert(std::is_nothrow_move_assignable<map_type>::value, "linked_hashmap move may not throw");
+
+bool same(map_type &m, const std::vector<int> &keys) {
+    if (m.size() != keys.size()) return false;
+    size_t i = 0;
+    for (map_type::iterator it = m.begin(); it != m.end(); ++it, ++i) {
+        if (it->first != keys[i] || it->second != std::to_string(keys[i])) return false;
+        if (m.find(keys[i]) != it || m.count(keys[i]) != 1) return false;
+    }
+    return true;
+}
+
+map_type make(int from, int to) {
+    map_type m;
+    for (int i = from; i < to; i++) m[i] = std::to_string(i);
+    return m;
+}
+
+bool testMove() {
+    map_type a = make(0, 100);
+    std::string *value = &a.at(42);
+    map_type b(std::move(a));
+    std::vector<int> keys;
+    for (int i = 0; i < 100; i++) keys.push_back(i);
+    if (!a.empty() || a.begin() != a.end() || a.count(42) != 0 || !same(b, keys) || &b.at(42) != value) return false;
+    // the moved-from map keeps working and grows from a single bucket
+    for (int i = 0; i < 50; i++) a[i * 3] = std::to_string(i * 3);
+    std::vector<int> triples;
+    for (int i = 0; i < 50; i++) triples.push_back(i * 3);
+    if (!same(a, triples)) return false;
+    a = std::move(b);
+    if (!same(a, keys) || !b.empty()) return false;
+    b.insert(map_type::value_type(7, "7"));
+    a = std::move(a);
+    return same(b, {7}) && same(a, keys);
+}
+
+bool testSwap() {
+    map_type a = make(0, 10), b = make(100, 103), empty_one;
+    swap(a, b);
+    if (!same(a, {100, 101, 102}) || !same(b, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9})) return false;
+    map_type moved(std::move(a));
+    // a sits on its spare bucket now, swapping it must not leave pointers into the other map
+    a[5] = "5";
+    a.swap(empty_one);
+    a.swap(b);
+    a.erase(a.find(3));
+    return same(empty_one, {5}) && same(b, {}) && same(a, {0, 1, 2, 4, 5, 6, 7, 8, 9}) && same(moved, {100, 101, 102});
+}
+
+bool testSeededHashTravels() {
+    typedef sjtu::linked_hashmap<std::string, int, sjtu::seeded_hash<std::string>> seeded_map;
+    seeded_map a, b;
+    for (int i = 0; i < 1000; i++) a[std::to_string(i)] = i, b[std::to_string(-i)] = -i;
+    a.swap(b);
+    for (int i = 0; i < 1000; i++) {
+        if (a.at(std::to_string(-i)) != -i || b.at(std::to_string(i)) != i) return false;
+    }
+    seeded_map c(std::move(a));
+    return c.count("-999") == 1 && a.count("-999") == 0;
+}
+
+int main() {
+    std::cout << (testMove() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testSwap() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testSeededHashTravels() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -6,7 +6,9 @@
 
 // only for std::equal_to<T> and std::hash<T>
 #include <functional>
+#include <atomic>
 #include <cstddef>
+#include <cstdio>
 #include "utility.hpp"
 #include "exceptions.hpp"
 
@@ -28,6 +30,49 @@ namespace sjtu {
             class Equal = std::equal_to<Key>
     >
     class linked_hashmap {
+    public:
+        /**
+         * counters kept when compiled with SJTU_STATS defined, all zero otherwise.
+         * SJTU_STATS changes the class layout: define it in every translation unit or in none.
+         * a lookup walks one bucket chain: probes is the number of nodes compared
+         * over all lookups, so probes / lookups is the mean chain walk.
+         * const lookups count into relaxed atomics, so concurrent readers of a const
+         * map stay race-free; stats() is then only a snapshot.
+         */
+        struct statistics {
+            size_t allocations = 0;
+            size_t bytes_allocated = 0;
+            size_t rehashes = 0;
+            size_t lookups = 0;
+            size_t probes = 0;
+            size_t max_probe = 0;
+        };
+
+        /**
+         * a snapshot of the bucket chains, see report_chains().
+         * histogram[k] is the number of buckets holding k nodes, the last slot
+         * also counts all the longer chains.
+         * collision_score is the expected cost of finding every key, sum of
+         * c * (c + 1) / 2 over the chains, divided by the same sum expected from a
+         * uniformly random hash: about 1 for a good hash, far above for a bad one.
+         */
+        struct chain_report {
+            static const size_t histogram_size = 16;
+            size_t buckets = 0;
+            size_t elements = 0;
+            size_t used_buckets = 0;
+            size_t max_chain = 0;
+            double load_factor = 0;
+            double mean_chain = 0;
+            double collision_score = 0;
+            size_t histogram[histogram_size] = {};
+        };
+
+        /**
+         * called on an insert that leaves a chain longer than the warning limit.
+         */
+        typedef void (*chain_warning)(const Key &key, size_t chain, size_t buckets);
+
     private:
         struct HashNode {
             pair<const Key, T> *data;
@@ -37,7 +82,7 @@ namespace sjtu {
                     : hash_next(hn), pre(p), next(n) {
                 data = new pair<const Key, T>(d);
             }
-            HashNode() : hash_next(nullptr), pre(nullptr), next(nullptr), data(nullptr) {}
+            HashNode() : data(nullptr), hash_next(nullptr), pre(nullptr), next(nullptr) {}
             ~HashNode() {
                 if (data != nullptr) {
                     delete data;
@@ -50,6 +95,138 @@ namespace sjtu {
         Hash MyHash;
         Equal MyEqual;
         HashNode *MyMap, *Head, *Tail;
+        /**
+         * Head and Tail point to these sentinels; SpareBucket is the only bucket
+         * of a map that has been moved from, so that it stays usable without allocating.
+         */
+        HashNode HeadNode, TailNode, SpareBucket;
+        size_t ChainLimit;
+        chain_warning ChainWarning;
+#ifdef SJTU_STATS
+        statistics _stats;
+        mutable std::atomic<size_t> _lookups{0}, _probes{0}, _max_probe{0};
+#endif
+
+        void note_allocation(size_t count, size_t bytes) {
+#ifdef SJTU_STATS
+            _stats.allocations += count;
+            _stats.bytes_allocated += bytes;
+#else
+            (void) count;
+            (void) bytes;
+#endif
+        }
+
+        void note_lookup(size_t probes) const {
+#ifdef SJTU_STATS
+            _lookups.fetch_add(1, std::memory_order_relaxed);
+            _probes.fetch_add(probes, std::memory_order_relaxed);
+            size_t seen = _max_probe.load(std::memory_order_relaxed);
+            while (probes > seen && !_max_probe.compare_exchange_weak(seen, probes, std::memory_order_relaxed)) {}
+#else
+            (void) probes;
+#endif
+        }
+
+        HashNode *new_node(const pair<const Key, T> &d, HashNode *hn, HashNode *p, HashNode *n) {
+            note_allocation(2, sizeof(HashNode) + sizeof(pair<const Key, T>));
+            return new HashNode(d, hn, p, n);
+        }
+
+        HashNode *new_buckets(size_t n) {
+            note_allocation(1, n * sizeof(HashNode));
+            return new HashNode[n];
+        }
+
+        /**
+         * the node of key in bucket pos, nullptr if there is none.
+         */
+        HashNode *locate(const Key &key, size_t pos) const {
+            size_t probes = 0;
+            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
+                probes++;
+                if (MyEqual(p->data->first, key)) {
+                    note_lookup(probes);
+                    return p;
+                }
+            }
+            note_lookup(probes);
+            return nullptr;
+        }
+
+        size_t chain_length(size_t pos) const {
+            size_t length = 0;
+            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) length++;
+            return length;
+        }
+
+        /**
+         * warn if the chain a key was just inserted into is over the limit.
+         */
+        void check_chain(const Key &key, size_t pos) const {
+            if (ChainLimit == 0) return;
+            size_t length = chain_length(pos);
+            if (length <= ChainLimit) return;
+            if (ChainWarning != nullptr) ChainWarning(key, length, Capacity);
+            else fprintf(stderr, "linked_hashmap: a chain of %zu nodes (limit %zu) in %zu buckets, check the hash\n",
+                         length, ChainLimit, Capacity);
+        }
+
+        void free_buckets() {
+            if (MyMap != &SpareBucket) delete[] MyMap;
+        }
+
+        /**
+         * take the buckets, nodes and hash of other, leaving it empty on SpareBucket.
+         * this map must be empty and its buckets freed.
+         */
+        void steal(linked_hashmap &other) {
+            Capacity = other.Capacity;
+            CurrentSize = other.CurrentSize;
+            LoadFactor = other.LoadFactor;
+            MyHash = other.MyHash;
+            MyEqual = other.MyEqual;
+            ChainLimit = other.ChainLimit;
+            ChainWarning = other.ChainWarning;
+            if (other.MyMap == &other.SpareBucket) {
+                MyMap = &SpareBucket;
+                SpareBucket.hash_next = other.SpareBucket.hash_next;
+            } else {
+                MyMap = other.MyMap;
+            }
+            Head->next = Tail;
+            Tail->pre = Head;
+            if (CurrentSize > 0) {
+                Head->next = other.Head->next;
+                Head->next->pre = Head;
+                Tail->pre = other.Tail->pre;
+                Tail->pre->next = Tail;
+            }
+            other.Capacity = 1;
+            other.CurrentSize = 0;
+            other.MyMap = &other.SpareBucket;
+            other.SpareBucket.hash_next = nullptr;
+            other.Head->next = other.Tail;
+            other.Tail->pre = other.Head;
+        }
+
+        /**
+         * double the buckets and relink every node into them.
+         */
+        void grow() {
+#ifdef SJTU_STATS
+            _stats.rehashes++;
+#endif
+            Capacity = Capacity << 1;
+            HashNode *NewMap = new_buckets(Capacity);
+            for (HashNode *p = Head->next; p != Tail; p = p->next) {
+                size_t ind = MyHash(p->data->first) % Capacity;
+                p->hash_next = NewMap[ind].hash_next;
+                NewMap[ind].hash_next = p;
+            }
+            free_buckets();
+            MyMap = NewMap;
+        }
 
     public:
         /**
@@ -228,20 +405,30 @@ namespace sjtu {
         /**
          * TODO two constructors
          */
-        linked_hashmap() : Capacity(20), CurrentSize(0), LoadFactor(0.618), MyMap(new HashNode[20]), Head(new HashNode),
-                           Tail(new HashNode) {
+        linked_hashmap() : Capacity(20), CurrentSize(0), LoadFactor(0.618), MyMap(new HashNode[20]), Head(&HeadNode),
+                           Tail(&TailNode), ChainLimit(0), ChainWarning(nullptr) {
+            note_allocation(1, 20 * sizeof(HashNode));
             Head->next = Tail;
             Tail->pre = Head;
         }
+        /**
+         * with given hash and equal objects, e.g. a seeded_hash with a fixed key.
+         */
+        explicit linked_hashmap(const Hash &hash, const Equal &equal = Equal()) : linked_hashmap() {
+            MyHash = hash;
+            MyEqual = equal;
+        }
         linked_hashmap(const linked_hashmap &other) : Capacity(20), CurrentSize(other.CurrentSize),
-                                                      LoadFactor(0.618), Head(new HashNode), Tail(new HashNode) {
+                                                      LoadFactor(0.618), MyHash(other.MyHash), MyEqual(other.MyEqual),
+                                                      Head(&HeadNode), Tail(&TailNode),
+                                                      ChainLimit(other.ChainLimit), ChainWarning(other.ChainWarning) {
             while (Capacity * LoadFactor <= CurrentSize) Capacity = Capacity << 1;
-            MyMap = new HashNode[Capacity];
+            MyMap = new_buckets(Capacity);
             Head->next = Tail;
             Tail->pre = Head;
             for (HashNode *p = other.Head->next; p != other.Tail; p = p->next) {
                 int pos = MyHash(p->data->first) % Capacity;
-                MyMap[pos].hash_next = new HashNode(*p->data, MyMap[pos].hash_next, Tail->pre, Tail);
+                MyMap[pos].hash_next = new_node(*p->data, MyMap[pos].hash_next, Tail->pre, Tail);
                 Tail->pre->next = MyMap[pos].hash_next;
                 Tail->pre = MyMap[pos].hash_next;
             }
@@ -254,14 +441,14 @@ namespace sjtu {
             if (&other == this) return *this;
             clear();
             if (other.CurrentSize == 0) { return *this; }
-            delete[] MyMap;
+            free_buckets();
             Capacity = 20;
             CurrentSize = other.CurrentSize;
             while (Capacity * LoadFactor <= CurrentSize) Capacity = Capacity << 1;
-            MyMap = new HashNode[Capacity];
+            MyMap = new_buckets(Capacity);
             for (HashNode *p = other.Head->next; p != other.Tail; p = p->next) {
                 int pos = MyHash(p->data->first) % Capacity;
-                MyMap[pos].hash_next = new HashNode(*p->data, MyMap[pos].hash_next, Tail->pre, Tail);
+                MyMap[pos].hash_next = new_node(*p->data, MyMap[pos].hash_next, Tail->pre, Tail);
                 Tail->pre->next = MyMap[pos].hash_next;
                 Tail->pre = MyMap[pos].hash_next;
             }
@@ -271,11 +458,34 @@ namespace sjtu {
         /**
          * TODO Destructors
          */
+        /**
+         * O(1), other is left empty. iterators into other are invalidated
+         * except those to its elements, which now belong to this map.
+         */
+        linked_hashmap(linked_hashmap &&other) noexcept
+                : Capacity(1), CurrentSize(0), LoadFactor(0.618), MyMap(&SpareBucket), Head(&HeadNode),
+                  Tail(&TailNode), ChainLimit(0), ChainWarning(nullptr) {
+            steal(other);
+        }
+
+        linked_hashmap &operator=(linked_hashmap &&other) noexcept {
+            if (&other == this) return *this;
+            clear();
+            free_buckets();
+            steal(other);
+            return *this;
+        }
+
+        void swap(linked_hashmap &other) noexcept {
+            if (&other == this) return;
+            linked_hashmap tmp(std::move(other));
+            other.steal(*this);
+            steal(tmp);
+        }
+
         ~linked_hashmap() {
             clear();
-            delete[] MyMap;
-            delete Head;
-            delete Tail;
+            free_buckets();
         }
 
         /**
@@ -285,18 +495,14 @@ namespace sjtu {
          * If no such element exists, an exception of type `index_out_of_bound'
          */
         T &at(const Key &key) {
-            size_t pos = MyHash(key) % Capacity;
-            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
-                if (MyEqual(p->data->first, key)) return p->data->second;
-            }
-            throw sjtu::index_out_of_bound();
+            HashNode *p = locate(key, MyHash(key) % Capacity);
+            if (p == nullptr) throw sjtu::index_out_of_bound();
+            return p->data->second;
         }
         const T &at(const Key &key) const {
-            size_t pos = MyHash(key) % Capacity;
-            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
-                if (MyEqual(p->data->first, key)) return p->data->second;
-            }
-            throw sjtu::index_out_of_bound();
+            HashNode *p = locate(key, MyHash(key) % Capacity);
+            if (p == nullptr) throw sjtu::index_out_of_bound();
+            return p->data->second;
         }
 
         /**
@@ -307,37 +513,25 @@ namespace sjtu {
          */
         T &operator[](const Key &key) {
             size_t pos = MyHash(key) % Capacity;
-            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
-                if (MyEqual((*p->data).first, key)) return p->data->second;
-            }
+            HashNode *found = locate(key, pos);
+            if (found != nullptr) return found->data->second;
             pair<Key, T> ins(key, T());
             if (CurrentSize >= Capacity * LoadFactor) {
-                Capacity = Capacity << 1;
+                grow();
                 pos = MyHash(key) % Capacity;
-                HashNode *NewMap = new HashNode[Capacity];
-                for (HashNode *p = Head->next; p != Tail; p = p->next) {
-                    int ind = MyHash(p->data->first) % Capacity;
-                    p->hash_next = NewMap[ind].hash_next;
-                    NewMap[ind].hash_next = p;
-                }
-                delete[] MyMap;
-                MyMap = NewMap;
             }
-            MyMap[pos].hash_next = new HashNode(ins, MyMap[pos].hash_next, Tail->pre, Tail);
+            MyMap[pos].hash_next = new_node(ins, MyMap[pos].hash_next, Tail->pre, Tail);
             Tail->pre->next = MyMap[pos].hash_next;
             Tail->pre = MyMap[pos].hash_next;
             CurrentSize++;
+            check_chain(key, pos);
             return MyMap[pos].hash_next->data->second;
         }
         /**
          * behave like at() throw index_out_of_bound if such key does not exist.
          */
         const T &operator[](const Key &key) const {
-            size_t pos = MyHash(key) % Capacity;
-            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
-                if (MyEqual(p->data->first, key)) return p->data->second;
-            }
-            throw sjtu::index_out_of_bound();
+            return at(key);
         }
 
         /**
@@ -376,7 +570,7 @@ namespace sjtu {
             }
             Head->next = Tail;
             Tail->pre = Head;
-            for (int i = 0; i < Capacity; i++) { MyMap[i].hash_next = nullptr; }
+            for (size_t i = 0; i < Capacity; i++) { MyMap[i].hash_next = nullptr; }
         }
 
         /**
@@ -386,28 +580,18 @@ namespace sjtu {
          *   the second one is true if insert successfully, or false.
          */
         pair<iterator, bool> insert(const value_type &value) {
-            int pos = MyHash(value.first) % Capacity;
-            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
-                if (MyEqual(p->data->first, value.first)) {
-                    return pair<iterator, bool>(iterator(p), false);
-                }
-            }
+            size_t pos = MyHash(value.first) % Capacity;
+            HashNode *found = locate(value.first, pos);
+            if (found != nullptr) return pair<iterator, bool>(iterator(found), false);
             if (CurrentSize >= Capacity * LoadFactor) {
-                Capacity = Capacity << 1;
+                grow();
                 pos = MyHash(value.first) % Capacity;
-                HashNode *NewMap = new HashNode[Capacity];
-                for (HashNode *p = Head->next; p != Tail; p = p->next) {
-                    int ind = MyHash((*p->data).first) % Capacity;
-                    p->hash_next = NewMap[ind].hash_next;
-                    NewMap[ind].hash_next = p;
-                }
-                delete[] MyMap;
-                MyMap = NewMap;
             }
-            MyMap[pos].hash_next = new HashNode(value, MyMap[pos].hash_next, Tail->pre, Tail);
+            MyMap[pos].hash_next = new_node(value, MyMap[pos].hash_next, Tail->pre, Tail);
             Tail->pre->next = MyMap[pos].hash_next;
             Tail->pre = MyMap[pos].hash_next;
             CurrentSize++;
+            check_chain(value.first, pos);
             return pair<iterator, bool>(iterator(MyMap[pos].hash_next), true);
         }
 
@@ -440,11 +624,7 @@ namespace sjtu {
          *     since this container does not allow duplicates.
          */
         size_t count(const Key &key) const {
-            size_t pos = MyHash(key) % Capacity;
-            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
-                if (MyEqual(p->data->first, key)) return 1;
-            }
-            return 0;
+            return locate(key, MyHash(key) % Capacity) == nullptr ? 0 : 1;
         }
 
         /**
@@ -454,22 +634,74 @@ namespace sjtu {
          *   If no such element is found, past-the-end (see end()) iterator is returned.
          */
         iterator find(const Key &key) {
-            size_t pos = MyHash(key) % Capacity;
-            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
-                if (MyEqual(p->data->first, key)) return iterator(p);
-            }
-            return end();
+            HashNode *p = locate(key, MyHash(key) % Capacity);
+            return p == nullptr ? end() : iterator(p);
         }
 
         const_iterator find(const Key &key) const {
-            size_t pos = MyHash(key) % Capacity;
-            for (HashNode *p = MyMap[pos].hash_next; p != nullptr; p = p->hash_next) {
-                if (MyEqual(p->data->first, key)) return const_iterator(p);
+            HashNode *p = locate(key, MyHash(key) % Capacity);
+            return p == nullptr ? cend() : const_iterator(p);
+        }
+
+        /**
+         * walk all the buckets (O(capacity + size)) and summarize the chains.
+         */
+        chain_report report_chains() const {
+            chain_report report;
+            report.buckets = Capacity;
+            report.elements = CurrentSize;
+            report.load_factor = (double) CurrentSize / Capacity;
+            double cost = 0;
+            for (size_t i = 0; i < Capacity; i++) {
+                size_t length = chain_length(i);
+                if (length > 0) report.used_buckets++;
+                if (length > report.max_chain) report.max_chain = length;
+                report.histogram[length < chain_report::histogram_size ? length : chain_report::histogram_size - 1]++;
+                cost += length * (length + 1) / 2.0;
             }
-            return cend();
+            if (report.used_buckets > 0) report.mean_chain = (double) CurrentSize / report.used_buckets;
+            // with n keys in m buckets uniformly, E[sum c * (c + 1) / 2] = n + n * (n - 1) / (2 * m)
+            double n = CurrentSize, expected = n + n * (n - 1) / (2.0 * Capacity);
+            report.collision_score = expected > 0 ? cost / expected : 1;
+            return report;
+        }
+
+        /**
+         * warn whenever an insert leaves a chain longer than limit (0 turns it off).
+         * without a callback the warning goes to stderr.
+         */
+        void warn_on_chain_length(size_t limit, chain_warning callback = nullptr) {
+            ChainLimit = limit;
+            ChainWarning = callback;
+        }
+
+        statistics stats() const {
+#ifdef SJTU_STATS
+            statistics s = _stats;
+            s.lookups = _lookups.load(std::memory_order_relaxed);
+            s.probes = _probes.load(std::memory_order_relaxed);
+            s.max_probe = _max_probe.load(std::memory_order_relaxed);
+            return s;
+#else
+            return statistics();
+#endif
+        }
+
+        void reset_stats() {
+#ifdef SJTU_STATS
+            _stats = statistics();
+            _lookups.store(0, std::memory_order_relaxed);
+            _probes.store(0, std::memory_order_relaxed);
+            _max_probe.store(0, std::memory_order_relaxed);
+#endif
         }
     };
 
+    template<class Key, class T, class Hash, class Equal>
+    void swap(linked_hashmap<Key, T, Hash, Equal> &a, linked_hashmap<Key, T, Hash, Equal> &b) noexcept {
+        a.swap(b);
+    }
+
 }
 
 #endif
\ No newline at end of file
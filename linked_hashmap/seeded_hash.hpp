@@ -0,0 +1,141 @@
+#ifndef SJTU_SEEDED_HASH_HPP
+#define SJTU_SEEDED_HASH_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <type_traits>
+
+namespace sjtu {
+
+    namespace detail {
+
+        inline uint64_t rotl(uint64_t x, int b) {
+            return (x << b) | (x >> (64 - b));
+        }
+
+        inline void sip_round(uint64_t &v0, uint64_t &v1, uint64_t &v2, uint64_t &v3) {
+            v0 += v1, v1 = rotl(v1, 13), v1 ^= v0, v0 = rotl(v0, 32);
+            v2 += v3, v3 = rotl(v3, 16), v3 ^= v2;
+            v0 += v3, v3 = rotl(v3, 21), v3 ^= v0;
+            v2 += v1, v1 = rotl(v1, 17), v1 ^= v2, v2 = rotl(v2, 32);
+        }
+
+        /**
+         * SipHash-2-4 of len bytes under the 128-bit key (k0, k1).
+         */
+        inline uint64_t siphash(uint64_t k0, uint64_t k1, const unsigned char *data, size_t len) {
+            uint64_t v0 = 0x736f6d6570736575ull ^ k0, v1 = 0x646f72616e646f6dull ^ k1;
+            uint64_t v2 = 0x6c7967656e657261ull ^ k0, v3 = 0x7465646279746573ull ^ k1;
+            const unsigned char *end = data + (len & ~(size_t) 7);
+            for (; data != end; data += 8) {
+                uint64_t m = 0;
+                for (int i = 0; i < 8; i++) m |= (uint64_t) data[i] << (8 * i);
+                v3 ^= m;
+                sip_round(v0, v1, v2, v3);
+                sip_round(v0, v1, v2, v3);
+                v0 ^= m;
+            }
+            uint64_t last = (uint64_t) len << 56;
+            for (size_t i = 0; i < (len & 7); i++) last |= (uint64_t) data[i] << (8 * i);
+            v3 ^= last;
+            sip_round(v0, v1, v2, v3);
+            sip_round(v0, v1, v2, v3);
+            v0 ^= last;
+            v2 ^= 0xff;
+            for (int i = 0; i < 4; i++) sip_round(v0, v1, v2, v3);
+            return v0 ^ v1 ^ v2 ^ v3;
+        }
+
+        /**
+         * 64x64 -> 128 bit multiply folded to 64 bits, the mixing step of wyhash.
+         */
+        inline uint64_t fold_multiply(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+            __uint128_t r = (__uint128_t) a * b;
+            return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+            uint64_t ha = a >> 32, la = (uint32_t) a, hb = b >> 32, lb = (uint32_t) b;
+            uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+            uint64_t mid = (ll >> 32) + (uint32_t) hl + (uint32_t) lh;
+            return (hh + (hl >> 32) + (lh >> 32) + (mid >> 32)) ^ ((mid << 32) | (uint32_t) ll);
+#endif
+        }
+
+        inline uint64_t splitmix(uint64_t &state) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * a fresh key for every seeded_hash: one random_device draw per process,
+         * then a counter stepped through splitmix.
+         */
+        inline void fresh_hash_key(uint64_t &k0, uint64_t &k1) {
+            static const uint64_t process_seed = []() {
+                std::random_device device;
+                uint64_t seed = ((uint64_t) device() << 32) ^ device();
+                return seed ^ (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count();
+            }();
+            static std::atomic<uint64_t> counter(0);
+            uint64_t state = process_seed ^ (counter.fetch_add(1, std::memory_order_relaxed) << 1);
+            k0 = splitmix(state);
+            k1 = splitmix(state);
+        }
+
+        template<class Key, class = void>
+        struct is_byte_string : std::false_type {};
+
+        template<class Key>
+        struct is_byte_string<Key, typename std::enable_if<
+                sizeof(*std::declval<const Key &>().data()) == 1 &&
+                std::is_integral<typename std::decay<decltype(*std::declval<const Key &>().data())>::type>::value &&
+                std::is_integral<decltype(std::declval<const Key &>().size())>::value>::type> : std::true_type {};
+    }
+
+    /**
+     * a keyed hash for linked_hashmap<Key, T, seeded_hash<Key>> when the keys come from
+     * outside: every instance draws its own random key, so a key set crafted to share
+     * one bucket chain under one map does not collide in another.
+     * strings (anything with byte data() and size()) go through SipHash-2-4,
+     * integers, enums and pointers through a keyed folded multiply, and other keys
+     * have their std::hash value mixed with the key.
+     * that last case only protects as far as std::hash<Key> does: keys that collide
+     * under std::hash<Key> collide under every seed, so for outside keys of another
+     * type hash a byte string of them (e.g. a serialized std::string) instead.
+     */
+    template<class Key>
+    class seeded_hash {
+    private:
+        uint64_t k0, k1;
+
+    public:
+        seeded_hash() { detail::fresh_hash_key(k0, k1); }
+
+        /**
+         * a fixed key, for reproducible runs.
+         */
+        seeded_hash(uint64_t key0, uint64_t key1) : k0(key0), k1(key1) {}
+
+        size_t operator()(const Key &key) const {
+            if constexpr (detail::is_byte_string<Key>::value) {
+                return (size_t) detail::siphash(k0, k1, reinterpret_cast<const unsigned char *>(key.data()),
+                                                key.size());
+            } else {
+                uint64_t bits;
+                if constexpr (std::is_integral<Key>::value || std::is_enum<Key>::value) bits = (uint64_t) key;
+                else if constexpr (std::is_pointer<Key>::value) bits = (uint64_t) (uintptr_t) key;
+                else bits = (uint64_t) std::hash<Key>()(key);
+                return (size_t) detail::fold_multiply(detail::fold_multiply(bits ^ k0, 0x9e3779b97f4a7c15ull ^ k1),
+                                                      0xd6e8feb86659fd93ull ^ k0);
+            }
+        }
+    };
+}
+
+#endif
@@ -1,46 +1,685 @@
 #ifndef SJTU_ALGORITHM_HPP
 #define SJTU_ALGORITHM_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu{
 
-    template<typename T>
-    void sort(T *begin, T *end, std::function<bool(const T&, const T&)> cmp){
-        int len = end - begin;
-        if (len <= 1) return ;
-        T *i = begin, *j = end - 1;
-        T pivot = *(begin + (len + 1) / 2 - 1);
-        while (j - i >= 0){
-            while (cmp(*i, pivot)) i++;
-            while (cmp(pivot, *j)) j--;
-            if (j - i >= 0){
+    template<class RandomIt, class T, class Compare>
+    RandomIt lower_bound(RandomIt begin, RandomIt end, const T &num, Compare cmp);
+
+    template<class RandomIt, class T, class Compare>
+    RandomIt upper_bound(RandomIt begin, RandomIt end, const T &num, Compare cmp);
+
+    namespace detail{
+
+        /**
+         * partitions not longer than this are left to insertion sort
+         */
+        const std::ptrdiff_t sort_threshold = 16;
+
+        /**
+         * value type of an iterator; sjtu iterators do not all provide iterator_traits.
+         */
+        template<class It>
+        using value_t = typename std::decay<decltype(*std::declval<It>())>::type;
+
+        template<class RandomIt, class Compare>
+        void insertion_sort(RandomIt begin, RandomIt end, Compare &cmp){
+            if (end - begin <= 1) return ;
+            for (RandomIt i = begin + 1; end - i > 0; ++i){
+                value_t<RandomIt> tmp = std::move(*i);
+                RandomIt j = i;
+                for (; j - begin > 0 && cmp(tmp, *(j - 1)); --j) *j = std::move(*(j - 1));
+                *j = std::move(tmp);
+            }
+        }
+
+        template<class RandomIt, class Compare>
+        void sift_down(RandomIt begin, std::ptrdiff_t i, std::ptrdiff_t len, Compare &cmp){
+            value_t<RandomIt> tmp = std::move(*(begin + i));
+            for (std::ptrdiff_t son = 2 * i + 1; son < len; i = son, son = 2 * i + 1){
+                if (son + 1 < len && cmp(*(begin + son), *(begin + (son + 1)))) son++;
+                if (!cmp(tmp, *(begin + son))) break;
+                *(begin + i) = std::move(*(begin + son));
+            }
+            *(begin + i) = std::move(tmp);
+        }
+
+        template<class RandomIt, class Compare>
+        void make_heap(RandomIt begin, RandomIt end, Compare &cmp){
+            std::ptrdiff_t len = end - begin;
+            for (std::ptrdiff_t i = len / 2 - 1; i >= 0; i--) detail::sift_down(begin, i, len, cmp);
+        }
+
+        template<class RandomIt, class Compare>
+        void sort_heap(RandomIt begin, RandomIt end, Compare &cmp){
+            for (std::ptrdiff_t i = end - begin - 1; i > 0; i--){
+                std::swap(*begin, *(begin + i));
+                detail::sift_down(begin, 0, i, cmp);
+            }
+        }
+
+        template<class RandomIt, class Compare>
+        void heap_sort(RandomIt begin, RandomIt end, Compare &cmp){
+            detail::make_heap(begin, end, cmp);
+            detail::sort_heap(begin, end, cmp);
+        }
+
+        template<class RandomIt, class Compare>
+        RandomIt median_of_three(RandomIt a, RandomIt b, RandomIt c, Compare &cmp){
+            if (cmp(*a, *b)){
+                if (cmp(*b, *c)) return b;
+                return cmp(*a, *c) ? c : a;
+            }
+            if (cmp(*a, *c)) return a;
+            return cmp(*b, *c) ? c : b;
+        }
+
+        /**
+         * move the pivot to *begin: median of three, or Tukey's ninther for long ranges.
+         * the candidates are taken from [begin + 1, end), so there is always an element
+         * not less and one not greater than the pivot left there to stop the partition scans.
+         */
+        template<class RandomIt, class Compare>
+        void move_pivot_to_begin(RandomIt begin, RandomIt end, Compare &cmp){
+            std::ptrdiff_t len = end - begin;
+            RandomIt a = begin + 1, mid = begin + len / 2, b = end - 1;
+            RandomIt pivot;
+            if (len > 128){
+                std::ptrdiff_t step = len / 8;
+                pivot = detail::median_of_three(detail::median_of_three(a, a + step, a + 2 * step, cmp),
+                                                detail::median_of_three(mid - step, mid, mid + step, cmp),
+                                                detail::median_of_three(b - 2 * step, b - step, b, cmp), cmp);
+            } else {
+                pivot = detail::median_of_three(a, mid, b, cmp);
+            }
+            std::swap(*begin, *pivot);
+        }
+
+        /**
+         * Hoare partition around *begin, returns the cut:
+         * [begin, cut) is not greater and [cut, end) is not less than the pivot.
+         */
+        template<class RandomIt, class Compare>
+        RandomIt partition(RandomIt begin, RandomIt end, Compare &cmp){
+            RandomIt i = begin + 1, j = end;
+            while (true){
+                while (cmp(*i, *begin)) ++i;
+                --j;
+                while (cmp(*begin, *j)) --j;
+                if (!(j - i > 0)) return i;
                 std::swap(*i, *j);
-                i++, j--;
+                ++i;
             }
         }
-        if (j - begin > 0) sort(begin, i, cmp);
-        if (end - i > 1) sort(i, end, cmp);
+
+        template<class RandomIt, class Compare>
+        void introsort(RandomIt begin, RandomIt end, int depth, Compare &cmp){
+            while (end - begin > sort_threshold){
+                if (depth == 0){
+                    detail::heap_sort(begin, end, cmp);
+                    return ;
+                }
+                depth--;
+                detail::move_pivot_to_begin(begin, end, cmp);
+                RandomIt cut = detail::partition(begin, end, cmp);
+                // recurse into the shorter side so the stack stays O(logn)
+                if (cut - begin < end - cut){
+                    detail::introsort(begin, cut, depth, cmp);
+                    begin = cut;
+                } else {
+                    detail::introsort(cut, end, depth, cmp);
+                    end = cut;
+                }
+            }
+            detail::insertion_sort(begin, end, cmp);
+        }
+
+        /**
+         * uninitialized storage for scratch elements, destroys the first size() of them on exit.
+         */
+        template<class T>
+        class raw_buffer{
+        private:
+            std::allocator<T> alloc;
+            T *_data;
+            std::size_t _capacity, _size;
+        public:
+            explicit raw_buffer(std::size_t n) : _data(alloc.allocate(n)), _capacity(n), _size(0) {}
+            /**
+             * leaves the buffer with capacity() == 0 instead of throwing bad_alloc
+             */
+            raw_buffer(std::size_t n, const std::nothrow_t &) : _data(nullptr), _capacity(0), _size(0){
+                try {
+                    _data = alloc.allocate(n);
+                    _capacity = n;
+                } catch (const std::bad_alloc &) {}
+            }
+            raw_buffer(const raw_buffer &) = delete;
+            raw_buffer &operator=(const raw_buffer &) = delete;
+            ~raw_buffer(){
+                for (std::size_t i = 0; i < _size; i++) alloc.destroy(_data + i);
+                if (_data != nullptr) alloc.deallocate(_data, _capacity);
+            }
+            template<class U>
+            void push_back(U &&value){
+                alloc.construct(_data + _size, std::forward<U>(value));
+                _size++;
+            }
+            /**
+             * for callers that construct [0, n) themselves, possibly out of order
+             */
+            void set_size(std::size_t n){ _size = n; }
+            T *data(){ return _data; }
+            std::size_t size() const { return _size; }
+            std::size_t capacity() const { return _capacity; }
+        };
+
+        /**
+         * scratch space for the merges: an iterator to constructed elements, or a
+         * raw_buffer whose slots are move constructed the first time they are filled.
+         */
+        template<class BufIt, class U>
+        void fill_buffer(BufIt buf, std::size_t i, U &value){
+            buf[i] = std::move(value);
+        }
+        template<class T, class U>
+        void fill_buffer(raw_buffer<T> *buf, std::size_t i, U &value){
+            if (i < buf->size()) buf->data()[i] = std::move(value);
+            else buf->push_back(std::move(value));
+        }
+        template<class BufIt>
+        BufIt buffer_begin(BufIt buf){ return buf; }
+        template<class T>
+        T *buffer_begin(raw_buffer<T> *buf){ return buf->data(); }
+
+        /**
+         * stable merge of the sorted runs [begin, mid) and [mid, end).
+         * buf must have room for mid - begin elements, see fill_buffer; the left run
+         * is moved there first and merged forward, ties are taken from the left.
+         */
+        template<class RandomIt, class BufIt, class Compare>
+        void merge_with_buffer(RandomIt begin, RandomIt mid, RandomIt end, BufIt buf, Compare &cmp){
+            std::size_t n = 0;
+            for (RandomIt i = begin; mid - i > 0; ++i, ++n) detail::fill_buffer(buf, n, *i);
+            auto l = detail::buffer_begin(buf), l_end = l + n;
+            RandomIt r = mid, out = begin;
+            while (l_end - l > 0 && end - r > 0){
+                if (cmp(*r, *l)) *out = std::move(*r), ++r;
+                else *out = std::move(*l), ++l;
+                ++out;
+            }
+            for (; l_end - l > 0; ++l, ++out) *out = std::move(*l);
+        }
+
+        /**
+         * top-down stable merge sort, buf has room for (end - begin + 1) / 2 elements.
+         */
+        template<class RandomIt, class BufIt, class Compare>
+        void merge_sort(RandomIt begin, RandomIt end, BufIt buf, Compare &cmp){
+            std::ptrdiff_t len = end - begin;
+            if (len <= sort_threshold){
+                detail::insertion_sort(begin, end, cmp);
+                return ;
+            }
+            RandomIt mid = begin + len / 2;
+            detail::merge_sort(begin, mid, buf, cmp);
+            detail::merge_sort(mid, end, buf, cmp);
+            if (!cmp(*mid, *(mid - 1))) return ;
+            detail::merge_with_buffer(begin, mid, end, buf, cmp);
+        }
+
+        template<class RandomIt>
+        void reverse(RandomIt begin, RandomIt end){
+            while (end - begin > 1){
+                --end;
+                std::swap(*begin, *end);
+                ++begin;
+            }
+        }
+
+        /**
+         * rotate [begin, end) so that mid comes first, returns the new position of *begin.
+         */
+        template<class RandomIt>
+        RandomIt rotate(RandomIt begin, RandomIt mid, RandomIt end){
+            detail::reverse(begin, mid);
+            detail::reverse(mid, end);
+            detail::reverse(begin, end);
+            return begin + (end - mid);
+        }
+
+        /**
+         * stable merge without a buffer: split the longer run in half, find the matching
+         * cut in the other one, rotate the middle parts and merge both sides recursively.
+         */
+        template<class RandomIt, class Compare>
+        void merge_in_place(RandomIt begin, RandomIt mid, RandomIt end, Compare &cmp){
+            std::ptrdiff_t len1 = mid - begin, len2 = end - mid;
+            if (len1 == 0 || len2 == 0) return ;
+            if (len1 + len2 == 2){
+                if (cmp(*mid, *begin)) std::swap(*begin, *mid);
+                return ;
+            }
+            RandomIt cut1, cut2;
+            if (len1 > len2){
+                cut1 = begin + len1 / 2;
+                cut2 = sjtu::lower_bound(mid, end, *cut1, cmp);
+            } else {
+                cut2 = mid + len2 / 2;
+                cut1 = sjtu::upper_bound(begin, mid, *cut2, cmp);
+            }
+            RandomIt new_mid = detail::rotate(cut1, mid, cut2);
+            detail::merge_in_place(begin, cut1, new_mid, cmp);
+            detail::merge_in_place(new_mid, cut2, end, cmp);
+        }
+
+        template<class RandomIt, class Compare>
+        void merge_sort_in_place(RandomIt begin, RandomIt end, Compare &cmp){
+            std::ptrdiff_t len = end - begin;
+            if (len <= sort_threshold){
+                detail::insertion_sort(begin, end, cmp);
+                return ;
+            }
+            RandomIt mid = begin + len / 2;
+            detail::merge_sort_in_place(begin, mid, cmp);
+            detail::merge_sort_in_place(mid, end, cmp);
+            if (!cmp(*mid, *(mid - 1))) return ;
+            detail::merge_in_place(begin, mid, end, cmp);
+        }
+
+        /**
+         * radix_traits<K>::image maps a key to an unsigned integer with the same order:
+         * the sign bit of signed integers is flipped, negative floating point numbers
+         * have all their bits flipped and the others only the sign bit.
+         */
+        template<class K, bool = std::is_integral<K>::value && !std::is_same<K, bool>::value>
+        struct radix_traits{
+            static const bool sortable = false;
+        };
+
+        template<class K>
+        struct radix_traits<K, true>{
+            static const bool sortable = true;
+            typedef typename std::make_unsigned<K>::type type;
+            static type image(K key){
+                type u = (type) key;
+                if (std::is_signed<K>::value) u ^= (type) ((type) 1 << (sizeof(type) * 8 - 1));
+                return u;
+            }
+        };
+
+        template<>
+        struct radix_traits<float, false>{
+            static const bool sortable = true;
+            typedef std::uint32_t type;
+            static type image(float key){
+                type u;
+                std::memcpy(&u, &key, sizeof(u));
+                return (u >> 31) ? ~u : u | 0x80000000u;
+            }
+        };
+
+        template<>
+        struct radix_traits<double, false>{
+            static const bool sortable = true;
+            typedef std::uint64_t type;
+            static type image(double key){
+                type u;
+                std::memcpy(&u, &key, sizeof(u));
+                return (u >> 63) ? ~u : u | 0x8000000000000000ull;
+            }
+        };
+
+        struct identity{
+            template<class T>
+            const T &operator()(const T &x) const { return x; }
+        };
+
+        /**
+         * below this length sort() keeps to introsort even for radix sortable types
+         */
+        const std::ptrdiff_t radix_threshold = 256;
+
+        inline int floor_log2(std::ptrdiff_t n){
+            int k = 0;
+            while (n > 1) n >>= 1, k++;
+            return k;
+        }
+    }
+
+    /**
+     * introsort: quicksort with median-of-three / ninther pivots, insertion sort for
+     * short partitions and heapsort once the depth passes 2logn, so O(nlogn) in the worst case.
+     * cmp may be any callable, it is taken by value once and inlined into the sort.
+     */
+    template<class RandomIt, class Compare>
+    void sort(RandomIt begin, RandomIt end, Compare cmp){
+        if (end - begin <= 1) return ;
+        detail::introsort(begin, end, 2 * detail::floor_log2(end - begin), cmp);
+    }
+
+    /**
+     * LSD radix sort by proj(element), which must return an integral type, float or double.
+     * one counting pass builds the histograms of all the 8-bit digits, then every digit
+     * that is not the same for all the keys takes a stable scatter pass through a buffer.
+     * stable, O(n * sizeof(key)) time and O(n) extra space.
+     *
+     * the histogram stays scalar: without AVX-512 conflict detection a vectorized
+     * increment is not faster than counting into one table per digit.
+     */
+    template<class RandomIt, class Proj>
+    void radix_sort(RandomIt begin, RandomIt end, Proj proj){
+        typedef detail::value_t<RandomIt> T;
+        typedef typename std::decay<decltype(proj(*begin))>::type K;
+        typedef detail::radix_traits<K> traits;
+        static_assert(traits::sortable, "radix_sort needs an integral or floating point key");
+        typedef typename traits::type U;
+        const int digits = sizeof(U);
+        std::ptrdiff_t n = end - begin;
+        if (n <= 1) return ;
+        std::size_t count[digits][256] = {};
+        for (RandomIt it = begin; end - it > 0; ++it){
+            U u = traits::image(proj(*it));
+            for (int d = 0; d < digits; d++) count[d][(u >> (8 * d)) & 255]++;
+        }
+        detail::raw_buffer<T> buf(n);
+        bool in_buf = false;
+        U first_image = traits::image(proj(*begin));
+        for (int d = 0; d < digits; d++){
+            if (count[d][(first_image >> (8 * d)) & 255] == (std::size_t) n) continue;
+            std::size_t offset[256], sum = 0;
+            for (int b = 0; b < 256; b++) offset[b] = sum, sum += count[d][b];
+            if (!in_buf && buf.size() == 0){
+                for (RandomIt it = begin; end - it > 0; ++it)
+                    new (buf.data() + offset[(traits::image(proj(*it)) >> (8 * d)) & 255]++) T(std::move(*it));
+                buf.set_size(n);
+            } else if (!in_buf){
+                for (RandomIt it = begin; end - it > 0; ++it)
+                    buf.data()[offset[(traits::image(proj(*it)) >> (8 * d)) & 255]++] = std::move(*it);
+            } else {
+                for (T *p = buf.data(); p < buf.data() + n; p++)
+                    *(begin + (std::ptrdiff_t) offset[(traits::image(proj(*p)) >> (8 * d)) & 255]++) = std::move(*p);
+            }
+            in_buf = !in_buf;
+        }
+        if (in_buf){
+            for (std::ptrdiff_t i = 0; i < n; i++) *(begin + i) = std::move(buf.data()[i]);
+        }
+    }
+
+    template<class RandomIt>
+    void radix_sort(RandomIt begin, RandomIt end){
+        sjtu::radix_sort(begin, end, detail::identity());
+    }
+
+    namespace detail{
+        template<class RandomIt>
+        void sort_dispatch(RandomIt begin, RandomIt end, std::true_type){
+            if (end - begin >= radix_threshold) sjtu::radix_sort(begin, end);
+            else sjtu::sort(begin, end, std::less<value_t<RandomIt>>());
+        }
+
+        template<class RandomIt>
+        void sort_dispatch(RandomIt begin, RandomIt end, std::false_type){
+            sjtu::sort(begin, end, std::less<value_t<RandomIt>>());
+        }
+    }
+
+    /**
+     * ascending sort with operator<; integral and floating point elements go to radix_sort.
+     */
+    template<class RandomIt>
+    void sort(RandomIt begin, RandomIt end){
+        typedef detail::value_t<RandomIt> T;
+        detail::sort_dispatch(begin, end, std::integral_constant<bool, detail::radix_traits<T>::sortable>());
+    }
+
+    /**
+     * keeps sort<T>(T *, T *, cmp) working for callers naming the element type.
+     */
+    template<typename T, class Compare>
+    void sort(T *begin, T *end, Compare cmp){
+        if (end - begin <= 1) return ;
+        detail::introsort(begin, end, 2 * detail::floor_log2(end - begin), cmp);
+    }
+
+    /**
+     * stable sort: buffered merge sort with a buffer of half the length, or an
+     * O(nlog^2n) merge sort with in-place merges if the buffer can not be allocated.
+     * runs that are already in order are not merged.
+     */
+    template<class RandomIt, class Compare>
+    void stable_sort(RandomIt begin, RandomIt end, Compare cmp){
+        typedef detail::value_t<RandomIt> T;
+        std::ptrdiff_t len = end - begin;
+        if (len <= 1) return ;
+        if (len <= detail::sort_threshold){
+            detail::insertion_sort(begin, end, cmp);
+            return ;
+        }
+        detail::raw_buffer<T> buf((len + 1) / 2, std::nothrow);
+        if (buf.capacity() == 0){
+            detail::merge_sort_in_place(begin, end, cmp);
+            return ;
+        }
+        detail::merge_sort(begin, end, &buf, cmp);
+    }
+
+    template<class RandomIt>
+    void stable_sort(RandomIt begin, RandomIt end){
+        sjtu::stable_sort(begin, end, std::less<detail::value_t<RandomIt>>());
+    }
+
+    /**
+     * introselect: put the element that would be at nth after sorting there, with nothing
+     * greater before it and nothing less after it. quickselect with the sort pivots,
+     * falling back to heapsort on the remaining range past 2logn rounds. O(n) expected.
+     */
+    template<class RandomIt, class Compare>
+    void nth_element(RandomIt begin, RandomIt nth, RandomIt end, Compare cmp){
+        if (end - nth <= 0 || nth - begin < 0) return ;
+        int depth = 2 * detail::floor_log2(end - begin);
+        while (end - begin > detail::sort_threshold){
+            if (depth == 0){
+                detail::heap_sort(begin, end, cmp);
+                return ;
+            }
+            depth--;
+            detail::move_pivot_to_begin(begin, end, cmp);
+            RandomIt cut = detail::partition(begin, end, cmp);
+            if (cut - nth > 0) end = cut;
+            else begin = cut;
+        }
+        detail::insertion_sort(begin, end, cmp);
+    }
+
+    template<class RandomIt>
+    void nth_element(RandomIt begin, RandomIt nth, RandomIt end){
+        sjtu::nth_element(begin, nth, end, std::less<detail::value_t<RandomIt>>());
+    }
+
+    /**
+     * sort the smallest mid - begin elements into [begin, mid), the rest are left in [mid, end)
+     * in no particular order. a heap of the kept elements screens the rest, O(nlogk).
+     */
+    template<class RandomIt, class Compare>
+    void partial_sort(RandomIt begin, RandomIt mid, RandomIt end, Compare cmp){
+        std::ptrdiff_t k = mid - begin;
+        if (k <= 0) return ;
+        detail::make_heap(begin, mid, cmp);
+        for (RandomIt it = mid; end - it > 0; ++it){
+            if (cmp(*it, *begin)){
+                std::swap(*it, *begin);
+                detail::sift_down(begin, 0, k, cmp);
+            }
+        }
+        detail::sort_heap(begin, mid, cmp);
+    }
+
+    template<class RandomIt>
+    void partial_sort(RandomIt begin, RandomIt mid, RandomIt end){
+        sjtu::partial_sort(begin, mid, end, std::less<detail::value_t<RandomIt>>());
+    }
+
+    /**
+     * the first element in [begin, end) with cmp(element, num) false.
+     * branchless: the range halves every step and the compare only selects the base.
+     */
+    template<class RandomIt, class T, class Compare>
+    RandomIt lower_bound(RandomIt begin, RandomIt end, const T &num, Compare cmp){
+        std::ptrdiff_t len = end - begin;
+        if (len <= 0) return begin;
+        while (len > 1){
+            std::ptrdiff_t half = len >> 1;
+            begin = cmp(*(begin + half), num) ? begin + half : begin;
+            len -= half;
+        }
+        return cmp(*begin, num) ? begin + 1 : begin;
+    }
+
+    /**
+     * the first element in [begin, end) with cmp(num, element) true.
+     */
+    template<class RandomIt, class T, class Compare>
+    RandomIt upper_bound(RandomIt begin, RandomIt end, const T &num, Compare cmp){
+        std::ptrdiff_t len = end - begin;
+        if (len <= 0) return begin;
+        while (len > 1){
+            std::ptrdiff_t half = len >> 1;
+            begin = cmp(num, *(begin + half)) ? begin : begin + half;
+            len -= half;
+        }
+        return cmp(num, *begin) ? begin : begin + 1;
+    }
+
+    template<class RandomIt, class T>
+    RandomIt lower_bound(RandomIt begin, RandomIt end, const T &num){
+        return sjtu::lower_bound(begin, end, num, std::less<>());
+    }
+
+    template<class RandomIt, class T>
+    RandomIt upper_bound(RandomIt begin, RandomIt end, const T &num){
+        return sjtu::upper_bound(begin, end, num, std::less<>());
     }
 
     template<class T>
     T *upper_bound(const T *begin, const T *end, const T &num){
-        int l = -1, r = end - begin;
-        while (l + 1 < r){
-            int mid = (l + r) >> 1;
-            if (num < *(begin + mid)) r = mid; else l = mid;
-        }
-        return const_cast<T *>(begin + r);
+        return const_cast<T *>(sjtu::upper_bound(begin, end, num, std::less<>()));
     }
 
     template<class T>
     T *lower_bound(const T *begin, const T *end, const T &num){
-        int l = -1, r = end - begin;
-        while (l + 1 < r){
-            int mid = (l + r) >> 1;
-            if (num <= *(begin + mid)) r = mid; else l = mid;
+        return const_cast<T *>(sjtu::lower_bound(begin, end, num, std::less<>()));
+    }
+
+    namespace detail{
+
+        /**
+         * searches run side by side in a batch, hiding each other's cache misses
+         */
+        const int search_group = 16;
+
+        template<class It>
+        void prefetch(It it){
+#if defined(__GNUC__)
+            __builtin_prefetch(&*it);
+#endif
+        }
+
+        /**
+         * for every query q write the position of the first element e with before(e, q) false.
+         * sorted queries gallop forward from the previous answer, the others are searched
+         * search_group at a time with the probes of the next step prefetched.
+         */
+        template<class RandomIt, class QueryIt, class OutputIt, class Before, class Compare>
+        OutputIt bound_batch(RandomIt begin, RandomIt end, QueryIt q_begin, QueryIt q_end, OutputIt out,
+                             Before before, Compare &cmp){
+            std::ptrdiff_t n = end - begin;
+            bool sorted = true;
+            for (QueryIt it = q_begin, pre = q_begin; sorted && it != q_end; pre = it, ++it)
+                if (it != q_begin && cmp(*it, *pre)) sorted = false;
+            if (sorted){
+                std::ptrdiff_t pos = 0;
+                for (QueryIt it = q_begin; it != q_end; ++it){
+                    std::ptrdiff_t step = 1, lo = pos;
+                    while (pos < n && before(*(begin + pos), *it)){
+                        lo = pos + 1;
+                        pos += step;
+                        step <<= 1;
+                    }
+                    if (pos > n) pos = n;
+                    while (lo < pos){
+                        std::ptrdiff_t mid = lo + (pos - lo) / 2;
+                        if (before(*(begin + mid), *it)) lo = mid + 1; else pos = mid;
+                    }
+                    *out = pos;
+                    ++out;
+                }
+                return out;
+            }
+            QueryIt q[search_group];
+            RandomIt base[search_group];
+            for (QueryIt it = q_begin; it != q_end;){
+                int g = 0;
+                for (; g < search_group && it != q_end; ++it, ++g) q[g] = it, base[g] = begin;
+                std::ptrdiff_t len = n;
+                while (len > 1){
+                    std::ptrdiff_t half = len >> 1;
+                    for (int i = 0; i < g; i++){
+                        base[i] = before(*(base[i] + half), *q[i]) ? base[i] + half : base[i];
+                        detail::prefetch(base[i] + (len - half) / 2);
+                    }
+                    len -= half;
+                }
+                for (int i = 0; i < g; i++){
+                    *out = (base[i] - begin) + (n > 0 && before(*base[i], *q[i]) ? 1 : 0);
+                    ++out;
+                }
+            }
+            return out;
         }
-        return const_cast<T *>(begin + r);
+    }
+
+    /**
+     * lower_bound for every query in [q_begin, q_end): writes the positions (offsets from begin)
+     * to out in query order. sorted queries are answered by galloping from the previous answer.
+     */
+    template<class RandomIt, class QueryIt, class OutputIt, class Compare>
+    OutputIt lower_bound_batch(RandomIt begin, RandomIt end, QueryIt q_begin, QueryIt q_end, OutputIt out, Compare cmp){
+        return detail::bound_batch(begin, end, q_begin, q_end, out,
+                                   [&cmp](const detail::value_t<RandomIt> &e, const detail::value_t<QueryIt> &q){
+                                       return cmp(e, q);
+                                   }, cmp);
+    }
+
+    template<class RandomIt, class QueryIt, class OutputIt>
+    OutputIt lower_bound_batch(RandomIt begin, RandomIt end, QueryIt q_begin, QueryIt q_end, OutputIt out){
+        return sjtu::lower_bound_batch(begin, end, q_begin, q_end, out, std::less<>());
+    }
+
+    /**
+     * upper_bound for every query, same as lower_bound_batch otherwise.
+     */
+    template<class RandomIt, class QueryIt, class OutputIt, class Compare>
+    OutputIt upper_bound_batch(RandomIt begin, RandomIt end, QueryIt q_begin, QueryIt q_end, OutputIt out, Compare cmp){
+        return detail::bound_batch(begin, end, q_begin, q_end, out,
+                                   [&cmp](const detail::value_t<RandomIt> &e, const detail::value_t<QueryIt> &q){
+                                       return !cmp(q, e);
+                                   }, cmp);
+    }
+
+    template<class RandomIt, class QueryIt, class OutputIt>
+    OutputIt upper_bound_batch(RandomIt begin, RandomIt end, QueryIt q_begin, QueryIt q_end, OutputIt out){
+        return sjtu::upper_bound_batch(begin, end, q_begin, q_end, out, std::less<>());
     }
 
 };
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "algorithm.hpp"
+
+unsigned seed = 114514;
+
+int rand() {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 1);
+}
+
+// only operator< is available
+struct Key {
+    int v;
+    bool operator<(const Key &rhs) const { return v < rhs.v; }
+};
+
+bool testComparators() {
+    std::vector<int> a(100000), b;
+    for (int &x : a) x = rand() % 5000;
+    b = a;
+    std::sort(b.begin(), b.end(), std::greater<int>());
+    std::vector<int> c = a;
+    sjtu::sort(c.begin(), c.end(), std::greater<int>());
+    if (c != b) return false;
+    c = a;
+    std::function<bool(const int &, const int &)> f = [](const int &x, const int &y) { return x > y; };
+    sjtu::sort(c.data(), c.data() + c.size(), f);
+    if (c != b) return false;
+    c = a;
+    sjtu::sort<int>(c.data(), c.data() + c.size(), [](const int &x, const int &y) { return x > y; });
+    if (c != b) return false;
+    c = a;
+    sjtu::sort(c.begin(), c.end());
+    std::reverse(b.begin(), b.end());
+    return c == b;
+}
+
+bool testBounds() {
+    std::vector<int> a(3000);
+    for (int &x : a) x = rand() % 1000;
+    std::sort(a.begin(), a.end());
+    const int *first = a.data(), *last = a.data() + a.size();
+    for (int q = -2; q <= 1002; q++) {
+        if (sjtu::lower_bound(first, last, q) - first != std::lower_bound(a.begin(), a.end(), q) - a.begin())
+            return false;
+        if (sjtu::upper_bound(first, last, q) - first != std::upper_bound(a.begin(), a.end(), q) - a.begin())
+            return false;
+        if (sjtu::lower_bound(a.begin(), a.end(), q) != std::lower_bound(a.begin(), a.end(), q)) return false;
+        if (sjtu::upper_bound(a.begin(), a.end(), q) != std::upper_bound(a.begin(), a.end(), q)) return false;
+    }
+    std::vector<int> d(a.rbegin(), a.rend());
+    for (int q = -2; q <= 1002; q++) {
+        if (sjtu::lower_bound(d.begin(), d.end(), q, std::greater<int>()) !=
+            std::lower_bound(d.begin(), d.end(), q, std::greater<int>()))
+            return false;
+        if (sjtu::upper_bound(d.begin(), d.end(), q, std::greater<int>()) !=
+            std::upper_bound(d.begin(), d.end(), q, std::greater<int>()))
+            return false;
+    }
+    int *none = nullptr;
+    if (sjtu::lower_bound(none, none, 1) != none || sjtu::upper_bound(none, none, 1) != none) return false;
+    Key keys[5] = {{1}, {3}, {3}, {5}, {7}};
+    sjtu::sort(keys, keys + 5);
+    return sjtu::lower_bound(keys, keys + 5, Key{3}) == keys + 1 && sjtu::upper_bound(keys, keys + 5, Key{3}) == keys + 3
+           && sjtu::lower_bound(keys, keys + 5, Key{8}) == keys + 5;
+}
+
+int main() {
+    std::cout << (testComparators() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testBounds() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
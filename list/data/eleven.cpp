@@ -0,0 +1,110 @@
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "algorithm.hpp"
+
+unsigned seed = 31415926;
+
+int rand() {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 1);
+}
+
+struct Row {
+    int dept, salary, id;
+};
+
+bool sameRows(const std::vector<Row> &a, const std::vector<Row> &b) {
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].dept != b[i].dept || a[i].salary != b[i].salary || a[i].id != b[i].id) return false;
+    }
+    return a.size() == b.size();
+}
+
+bool testStableSort() {
+    const int N = 100000;
+    std::vector<Row> rows(N);
+    for (int i = 0; i < N; i++) rows[i] = {rand() % 10, rand() % 100, i};
+    auto bySalary = [](const Row &x, const Row &y) { return x.salary < y.salary; };
+    auto byDept = [](const Row &x, const Row &y) { return x.dept < y.dept; };
+    // multi-key: salary first, then a stable pass on dept
+    std::vector<Row> a = rows, b = rows, c = rows;
+    sjtu::stable_sort(a.begin(), a.end(), bySalary);
+    sjtu::stable_sort(a.begin(), a.end(), byDept);
+    std::stable_sort(b.begin(), b.end(), bySalary);
+    std::stable_sort(b.begin(), b.end(), byDept);
+    if (!sameRows(a, b)) return false;
+    // the fallback used when no buffer can be allocated
+    sjtu::detail::merge_sort_in_place(c.begin(), c.end(), bySalary);
+    sjtu::detail::merge_sort_in_place(c.begin(), c.end(), byDept);
+    if (!sameRows(c, b)) return false;
+    std::vector<int> v(1000);
+    for (int &x : v) x = rand() % 50;
+    std::vector<int> w = v;
+    sjtu::stable_sort(v.data(), v.data() + v.size());
+    std::sort(w.begin(), w.end());
+    return v == w;
+}
+
+bool testMoveOnly() {
+    // the buffer is filled by moving, so a move-only type sorts too
+    std::vector<std::unique_ptr<Row>> rows;
+    for (int i = 0; i < 5001; i++) rows.emplace_back(new Row{rand() % 10, 0, i});
+    sjtu::stable_sort(rows.begin(), rows.end(), [](const std::unique_ptr<Row> &x, const std::unique_ptr<Row> &y) {
+        return x->dept < y->dept;
+    });
+    for (size_t i = 1; i < rows.size(); i++) {
+        const Row &x = *rows[i - 1], &y = *rows[i];
+        if (x.dept > y.dept || (x.dept == y.dept && x.id > y.id)) return false;
+    }
+    return rows.size() == 5001;
+}
+
+bool testNthElement() {
+    for (int n : {1, 2, 17, 100, 100000}) {
+        std::vector<int> a(n);
+        for (int &x : a) x = rand() % (n / 2 + 1);
+        std::vector<int> sorted = a;
+        std::sort(sorted.begin(), sorted.end());
+        for (int k : {0, n / 4, n / 2, n * 99 / 100, n - 1}) {
+            std::vector<int> b = a;
+            sjtu::nth_element(b.begin(), b.begin() + k, b.end());
+            if (b[k] != sorted[k]) return false;
+            for (int i = 0; i < k; i++) if (b[k] < b[i]) return false;
+            for (int i = k + 1; i < n; i++) if (b[i] < b[k]) return false;
+        }
+    }
+    // median of a killer-like organ pipe, with a reversed comparator
+    std::vector<int> pipe(50001);
+    for (int i = 0; i <= 50000; i++) pipe[i] = i < 25000 ? i : 50000 - i;
+    sjtu::nth_element(pipe.begin(), pipe.begin() + 25000, pipe.end(), std::greater<int>());
+    return pipe[25000] == 12500;
+}
+
+bool testPartialSort() {
+    for (int n : {0, 1, 10, 100000}) {
+        std::vector<int> a(n);
+        for (int &x : a) x = rand() % 1000;
+        std::vector<int> sorted = a;
+        std::sort(sorted.begin(), sorted.end());
+        for (int k : {0, 1, n / 10, n}) {
+            if (k > n) continue;
+            std::vector<int> b = a;
+            sjtu::partial_sort(b.begin(), b.begin() + k, b.end());
+            if (!std::equal(b.begin(), b.begin() + k, sorted.begin())) return false;
+            std::sort(b.begin(), b.end());
+            if (b != sorted) return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << (testStableSort() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testMoveOnly() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testNthElement() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testPartialSort() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
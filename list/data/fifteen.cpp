@@ -0,0 +1,158 @@
+#define SJTU_STATS
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_nothrow_move_constructible<sjtu::ring_buffer<int>>::value, "ring_buffer move may not throw");
+static_assert(std::is_nothrow_move_assignable<sjtu::ring_buffer<int>>::value, "ring_buffer move may not throw");
+
+template<class T>
+bool same(const sjtu::ring_buffer<T> &r, const std::deque<T> &expected) {
+    if (r.size() != expected.size()) return false;
+    size_t i = 0;
+    for (typename sjtu::ring_buffer<T>::const_iterator it = r.cbegin(); it != r.cend(); ++it, ++i) {
+        if (*it != expected[i] || r[i] != expected[i]) return false;
+    }
+    return true;
+}
+
+bool testAgainstDeque() {
+    sjtu::ring_buffer<int> r;
+    std::deque<int> d;
+    unsigned seed = 3;
+    for (int step = 0; step < 50000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int op = seed >> 16 & 7, x = (int) (seed >> 8);
+        if (op < 3) {
+            r.push_back(x);
+            d.push_back(x);
+        } else if (op < 5) {
+            r.push_front(x);
+            d.push_front(x);
+        } else if (d.empty()) {
+            continue;
+        } else if (op < 7) {
+            r.pop_front();
+            d.pop_front();
+        } else {
+            r.pop_back();
+            d.pop_back();
+        }
+        if (r.size() != d.size() || (!d.empty() && (r.front() != d.front() || r.back() != d.back()))) return false;
+    }
+    if (!same(r, d)) return false;
+    std::sort(r.begin(), r.end());
+    std::sort(d.begin(), d.end());
+    size_t capacity = r.capacity();
+    return same(r, d) && (capacity & (capacity - 1)) == 0 && r.end() - r.begin() == (int) d.size();
+}
+
+bool testFifo() {
+    sjtu::ring_buffer<std::string> q;
+    long long letters = 0;
+    // a queue that never holds more than 100 strings reaches a steady capacity
+    for (int i = 0; i < 100000; i++) {
+        q.push_back(std::to_string(i));
+        if (q.size() > 100) {
+            letters += q.front().size();
+            q.pop_front();
+        }
+    }
+    if (q.capacity() != 128 || q.stats().allocations != 5 || q.front() != "99900") return false;
+    q.push_back(q.front());  // the value lives in the buffer itself
+    q.push_front(q.back());
+    return letters > 0 && q.size() == 102 && q.front() == "99900" && q.back() == "99900" && q[1] == "99900";
+}
+
+bool testWindow() {
+    sjtu::ring_buffer<std::string> w(5);
+    for (int i = 0; i < 12; i++) w.push_back(std::to_string(i));
+    if (!w.full() || !same(w, {"7", "8", "9", "10", "11"}) || w.capacity() != 8) return false;
+    w.push_front("a");  // drops the newest
+    if (!same(w, {"a", "7", "8", "9", "10"})) return false;
+    sjtu::ring_buffer<int> exact(4);
+    for (int i = 0; i < 10; i++) exact.emplace_back(i);
+    exact.push_back(exact.front());
+    std::deque<int> expected = {7, 8, 9, 6};
+    if (!same(exact, expected) || exact.stats().overwrites != 7 || exact.stats().allocations != 1) return false;
+    exact.reserve(100);
+    int caught = 0;
+    try { sjtu::ring_buffer<int> none(0); } catch (const sjtu::runtime_error &) { caught++; }
+    try { exact.at(4); } catch (const sjtu::index_out_of_bound &) { caught++; }
+    sjtu::ring_buffer<int> empty;
+    try { empty.pop_front(); } catch (const sjtu::container_is_empty &) { caught++; }
+    try { empty.back(); } catch (const sjtu::container_is_empty &) { caught++; }
+    try { (void) (empty.begin() - exact.begin()); } catch (const sjtu::invalid_iterator &) { caught++; }
+    return caught == 5 && exact.capacity() == 4 && exact.window() == 4 && empty.window() == 0;
+}
+
+/**
+ * a value whose move may throw, and whose copies throw once the budget runs out
+ */
+struct fragile {
+    static int budget;
+    std::string s;
+
+    fragile(const std::string &s) : s(s) {}
+
+    fragile(const fragile &other) : s(other.s) {
+        if (budget-- == 0) throw std::bad_alloc();
+    }
+
+    fragile(fragile &&other) noexcept(false) : s(std::move(other.s)) {}
+
+    fragile &operator=(const fragile &) = default;
+};
+
+int fragile::budget = -1;
+
+bool testThrowingGrowth() {
+    sjtu::ring_buffer<fragile> r;
+    for (int i = 0; i < 8; i++) r.push_front(fragile(std::string(30, 'a' + i)));
+    int caught = 0;
+    // growing copies the 8 elements: throw on the first copy and part way through
+    fragile::budget = 0;
+    try { r.emplace_back(std::string(30, 'z')); } catch (const std::bad_alloc &) { caught++; }
+    fragile::budget = 4;
+    try { r.emplace_back(std::string(30, 'z')); } catch (const std::bad_alloc &) { caught++; }
+    fragile::budget = 3;
+    try { r.reserve(100); } catch (const std::bad_alloc &) { caught++; }
+    fragile::budget = -1;
+    if (caught != 3 || r.size() != 8 || r.capacity() != 8) return false;
+    r.emplace_back(std::string(30, 'z'));
+    if (r.size() != 9 || r.capacity() != 16) return false;
+    for (int i = 0; i < 8; i++) {
+        if (r[i].s != std::string(30, 'h' - i)) return false;
+    }
+    return r.back().s == std::string(30, 'z');
+}
+
+bool testCopyMove() {
+    sjtu::ring_buffer<std::string> a(3);
+    for (int i = 0; i < 4; i++) a.push_back(std::string(20, 'a' + i));
+    sjtu::ring_buffer<std::string> b(a), c(std::move(a));
+    if (!a.empty() || a.window() != 0 || !same(b, {std::string(20, 'b'), std::string(20, 'c'), std::string(20, 'd')})) {
+        return false;
+    }
+    a.push_back("x");
+    swap(a, c);
+    c = b;
+    b = std::move(a);
+    b.push_back("e");  // still a window of 3
+    return c.size() == 3 && b.size() == 3 && b.front() == std::string(20, 'c') && b.back() == "e";
+}
+
+int main() {
+    std::cout << (testAgainstDeque() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testFifo() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testWindow() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testThrowingGrowth() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testCopyMove() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
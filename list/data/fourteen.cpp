@@ -0,0 +1,77 @@
+#define SJTU_STATS
+
+#include "list.hpp"
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static_assert(std::is_nothrow_move_constructible<sjtu::list<int>>::value, "list move may not throw");
+static_assert(std::is_nothrow_move_assignable<sjtu::list<int>>::value, "list move may not throw");
+
+template<class T>
+bool same(const sjtu::list<T> &l, const std::vector<T> &expected) {
+    if (l.size() != expected.size()) return false;
+    size_t i = 0;
+    for (typename sjtu::list<T>::const_iterator it = l.cbegin(); it != l.cend(); ++it, ++i) {
+        if (*it != expected[i]) return false;
+    }
+    return true;
+}
+
+sjtu::list<std::string> make(int n) {
+    sjtu::list<std::string> l;
+    for (int i = 0; i < n; i++) l.push_back(std::to_string(i));
+    return l;
+}
+
+bool testMove() {
+    sjtu::list<std::string> a = make(3);
+    sjtu::list<std::string> b(std::move(a));
+    if (!a.empty() || !same(b, {"0", "1", "2"}) || b.stats().node_allocations != 0) return false;
+    // a moved-from list is an ordinary empty list
+    a.push_back("x");
+    a.push_front("w");
+    if (!same(a, {"w", "x"})) return false;
+    a = std::move(b);
+    if (!b.empty() || !same(a, {"0", "1", "2"})) return false;
+    b = std::move(b);
+    b.push_back("y");
+    a = sjtu::list<std::string>();
+    return a.empty() && same(b, {"y"}) && a.begin() == a.end();
+}
+
+bool testSwap() {
+    sjtu::list<int> a, b;
+    for (int i = 0; i < 5; i++) a.push_back(i);
+    swap(a, b);
+    if (!a.empty() || !same(b, {0, 1, 2, 3, 4})) return false;
+    a.push_back(9);
+    a.swap(b);
+    if (!same(a, {0, 1, 2, 3, 4}) || !same(b, {9})) return false;
+    a.erase(a.begin());
+    b.insert(b.end(), 10);
+    --b.end();
+    return same(a, {1, 2, 3, 4}) && same(b, {9, 10}) && a.back() == 4 && b.front() == 9;
+}
+
+bool testInStdVector() {
+    // std::vector relocates by move only when the move can not throw,
+    // so the nodes of the first list stay where they are
+    std::vector<sjtu::list<int>> lists;
+    const int *first = nullptr;
+    for (int i = 0; i < 200; i++) {
+        lists.emplace_back();
+        for (int j = 0; j < 10; j++) lists.back().push_back(i * 10 + j);
+        if (i == 0) first = &lists[0].front();
+    }
+    return &lists[0].front() == first && lists[150].front() == 1500 && lists[199].back() == 1999;
+}
+
+int main() {
+    std::cout << (testMove() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testSwap() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testInStdVector() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
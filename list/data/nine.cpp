@@ -0,0 +1,63 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include "parallel_sort.hpp"
+
+unsigned seed = 7340033;
+
+int rand() {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 1);
+}
+
+struct Record {
+    int key, id;
+};
+
+bool testUnstable() {
+    const int N = 1000000;
+    for (unsigned threads = 1; threads <= 8; threads *= 2) {
+        std::vector<int> a(N);
+        for (int &x : a) x = rand();
+        std::vector<int> b = a;
+        std::sort(b.begin(), b.end());
+        sjtu::parallel_sort(a.begin(), a.end(), [](const int &x, const int &y) { return x < y; }, threads);
+        if (a != b) return false;
+    }
+    // a single huge bucket of equal keys, and an already sorted input
+    std::vector<int> c(N, 42);
+    sjtu::parallel_sort(c.data(), c.data() + N, [](const int &x, const int &y) { return x < y; }, 4);
+    if (std::count(c.begin(), c.end(), 42) != N) return false;
+    for (int i = 0; i < N; i++) c[i] = N - i;
+    sjtu::parallel_sort(c.begin(), c.end());
+    return std::is_sorted(c.begin(), c.end());
+}
+
+bool testStable() {
+    const int N = 600000;
+    for (int distinct : {3, 1000, 1 << 30}) {
+        std::vector<Record> a(N);
+        for (int i = 0; i < N; i++) a[i] = {rand() % distinct, i};
+        std::vector<Record> b = a;
+        auto cmp = [](const Record &x, const Record &y) { return x.key < y.key; };
+        std::stable_sort(b.begin(), b.end(), cmp);
+        sjtu::parallel_sort(a.begin(), a.end(), cmp, 4, true);
+        for (int i = 0; i < N; i++) {
+            if (a[i].key != b[i].key || a[i].id != b[i].id) return false;
+        }
+    }
+    std::vector<Record> small(100);
+    for (int i = 0; i < 100; i++) small[i] = {rand() % 5, i};
+    sjtu::parallel_sort(small.begin(), small.end(), [](const Record &x, const Record &y) { return x.key < y.key; }, 4, true);
+    for (int i = 1; i < 100; i++) {
+        if (small[i - 1].key > small[i].key || (small[i - 1].key == small[i].key && small[i - 1].id > small[i].id))
+            return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << (testUnstable() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testStable() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "algorithm.hpp"
+
+unsigned seed = 998244353;
+
+int rand() {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 1);
+}
+
+long long comparisons;
+
+bool check(std::vector<int> a) {
+    std::vector<int> b = a;
+    std::sort(b.begin(), b.end());
+    comparisons = 0;
+    sjtu::sort<int>(a.data(), a.data() + a.size(), [](const int &x, const int &y) {
+        comparisons++;
+        return x < y;
+    });
+    double n = a.size() + 2;
+    // O(nlogn) with a generous constant even on adversarial input
+    return a == b && comparisons <= 8 * n * std::log2(n);
+}
+
+bool testPatterns() {
+    const int N = 200000;
+    std::vector<int> a(N);
+    for (int i = 0; i < N; i++) a[i] = rand();
+    if (!check(a)) return false;
+    for (int i = 0; i < N; i++) a[i] = i;
+    if (!check(a)) return false;
+    for (int i = 0; i < N; i++) a[i] = N - i;
+    if (!check(a)) return false;
+    for (int i = 0; i < N; i++) a[i] = 7;
+    if (!check(a)) return false;
+    for (int i = 0; i < N; i++) a[i] = i < N / 2 ? i : N - i;  // organ pipe
+    if (!check(a)) return false;
+    for (int i = 0; i < N; i++) a[i] = i % 1000;  // sawtooth
+    if (!check(a)) return false;
+    for (int i = 0; i < N; i++) a[i] = rand() % 4;
+    if (!check(a)) return false;
+    for (int i = 0; i < N; i++) a[i] = i & 1 ? i : N - i;  // interleaved
+    if (!check(a)) return false;
+    for (int n = 0; n < 100; n++) {
+        std::vector<int> small(n);
+        for (int i = 0; i < n; i++) small[i] = rand() % 10;
+        if (!check(small)) return false;
+    }
+    return true;
+}
+
+bool testKiller() {
+    // median-of-3 killer sequence (Musser)
+    const int N = 1 << 16;
+    std::vector<int> a(N);
+    int k = N / 2;
+    for (int i = 1; i <= k; i++) {
+        if (i & 1) a[i - 1] = i, a[i] = k + i;
+        a[k + i - 1] = 2 * i;
+    }
+    return check(a);
+}
+
+int main() {
+    std::cout << (testPatterns() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testKiller() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
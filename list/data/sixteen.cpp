@@ -0,0 +1,152 @@
+#include "spsc_queue.hpp"
+#include "mpmc_queue.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+bool testSingleThread() {
+    sjtu::spsc_queue<std::string> s(5);
+    sjtu::mpmc_queue<std::string> m(5);
+    if (s.capacity() != 8 || m.capacity() != 8 || !s.empty() || !m.empty()) return false;
+    for (int i = 0; i < 8; i++) {
+        if (!s.try_push(std::to_string(i)) || !m.try_emplace(3, 'a' + i)) return false;
+    }
+    int caught = 0;
+    if (s.try_push("x") || m.try_push("x")) return false;
+    try { s.push("x"); } catch (const sjtu::runtime_error &) { caught++; }
+    try { m.push("x"); } catch (const sjtu::runtime_error &) { caught++; }
+    std::string out;
+    if (!s.try_pop(out) || out != "0" || m.pop() != "aaa" || s.size() != 7 || m.size() != 7) return false;
+    std::string taken[8];
+    if (s.pop_batch(taken, 8) != 7 || taken[6] != "7" || m.pop_batch(taken, 3) != 3 || taken[2] != "ddd") return false;
+    std::string more[] = {"p", "q", "r"}, again[] = {"p", "q", "r"};  // the batches move from their input
+    if (s.push_batch(more, 3) != 3 || m.push_batch(again, 3) != 3 || !more[0].empty()) return false;
+    while (m.try_pop(out)) {}
+    if (out != "r" || s.pop() != "p") return false;
+    try { m.pop(); } catch (const sjtu::container_is_empty &) { caught++; }
+    try { sjtu::spsc_queue<int> none(0); } catch (const sjtu::runtime_error &) { caught++; }
+    return caught == 4 && m.empty() && s.size() == 2;  // s is destroyed with elements left
+}
+
+/**
+ * an output iterator that throws on its second element
+ */
+struct short_output {
+    std::vector<std::string> *to;
+
+    short_output &operator*() { return *this; }
+
+    short_output &operator++() { return *this; }
+
+    short_output &operator=(std::string &&s) {
+        if (!to->empty()) throw 1;
+        to->push_back(std::move(s));
+        return *this;
+    }
+};
+
+bool testThrowingOutput() {
+    sjtu::mpmc_queue<std::string> m(8);
+    for (int i = 0; i < 8; i++) m.push(std::string(30, 'a' + i));
+    std::vector<std::string> got;
+    int caught = 0;
+    try { m.pop_batch(short_output{&got}, 8); } catch (int) { caught++; }
+    // the cells of the dropped elements are free again
+    if (caught != 1 || got.size() != 1 || got[0] != std::string(30, 'a') || !m.empty()) return false;
+    for (int i = 0; i < 8; i++) {
+        if (!m.try_push("again")) return false;
+    }
+    return m.size() == 8 && m.pop() == "again";
+}
+
+/**
+ * one producer and one consumer through a small ring, half of it in batches:
+ * the consumer must see 0, 1, 2, ... in order
+ */
+bool testSpscOrder() {
+    const int n = 200000;
+    sjtu::spsc_queue<long long> q(64);
+    std::thread producer([&q]() {
+        long long next = 0;
+        while (next < n) {
+            if (next < n / 2) {
+                if (!q.try_push(next)) std::this_thread::yield();
+                else next++;
+            } else {
+                long long batch[16];
+                int k = 0;
+                for (; k < 16 && next + k < n; k++) batch[k] = next + k;
+                size_t pushed = q.push_batch(batch, k);
+                if (pushed == 0) std::this_thread::yield();
+                next += pushed;
+            }
+        }
+    });
+    long long expect = 0;
+    bool ordered = true;
+    while (expect < n) {
+        long long got[32];
+        size_t k = q.pop_batch(got, expect % 3 == 0 ? 1 : 32);
+        if (k == 0) std::this_thread::yield();
+        for (size_t i = 0; i < k; i++) ordered &= got[i] == expect++;
+    }
+    producer.join();
+    return ordered && q.empty();
+}
+
+/**
+ * four producers and four consumers: every value arrives exactly once, and the
+ * values of one producer arrive in the order pushed as seen by each consumer
+ */
+bool testMpmc() {
+    const int producers = 4, consumers = 4, per = 50000;
+    sjtu::mpmc_queue<int> q(128);
+    std::vector<std::atomic<int>> seen(producers * per);
+    for (auto &x : seen) x.store(0);
+    std::atomic<int> received(0);
+    std::atomic<bool> ordered(true);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&q, p]() {
+            for (int i = 0; i < per;) {
+                int batch[8];
+                int k = 0;
+                for (; k < 8 && i + k < per; k++) batch[k] = p * per + i + k;
+                size_t pushed = p % 2 == 0 ? q.push_batch(batch, k) : q.try_push(batch[0]) ? 1 : 0;
+                if (pushed == 0) std::this_thread::yield();
+                i += pushed;
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&, c]() {
+            int last[producers];
+            for (int p = 0; p < producers; p++) last[p] = -1;
+            while (received.load() < producers * per) {
+                int got[8];
+                size_t k = c % 2 == 0 ? q.pop_batch(got, 8) : q.try_pop(got[0]) ? 1 : 0;
+                if (k == 0) std::this_thread::yield();
+                for (size_t i = 0; i < k; i++) {
+                    seen[got[i]]++;
+                    if (got[i] <= last[got[i] / per]) ordered = false;
+                    last[got[i] / per] = got[i];
+                }
+                received += (int) k;
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+    for (auto &x : seen) if (x.load() != 1) return false;
+    return ordered && q.empty();
+}
+
+int main() {
+    std::cout << (testSingleThread() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testThrowingOutput() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testSpscOrder() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testMpmc() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "algorithm.hpp"
+#include "list.hpp"
+
+unsigned long long seed = 2463534242ull;
+
+unsigned long long rand64() {
+    seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+    return seed;
+}
+
+template<class T>
+bool check(std::vector<T> a) {
+    std::vector<T> b = a, c = a;
+    std::sort(b.begin(), b.end());
+    sjtu::radix_sort(a.begin(), a.end());
+    sjtu::sort(c.data(), c.data() + c.size());
+    return a == b && c == b;
+}
+
+struct Event {
+    long long time;
+    int id;
+};
+
+bool testKeys() {
+    const int N = 100000;
+    std::vector<int> i32(N);
+    for (int &x : i32) x = (int) rand64();
+    std::vector<long long> i64(N);
+    for (long long &x : i64) x = (long long) rand64();
+    std::vector<unsigned> u32(N);
+    for (unsigned &x : u32) x = (unsigned) rand64() % 1000;
+    std::vector<short> i16(N);
+    for (short &x : i16) x = (short) rand64();
+    std::vector<double> f64(N);
+    for (double &x : f64) x = ((long long) rand64() % 2000000 - 1000000) / 7.0;
+    f64[0] = -0.0, f64[1] = std::numeric_limits<double>::infinity(), f64[2] = -std::numeric_limits<double>::infinity();
+    std::vector<float> f32(N);
+    for (float &x : f32) x = (float) (((long long) rand64() % 20000 - 10000) * 1e-3);
+    std::vector<int> same(N, -5), tiny = {3, -1, 2};
+    return check(i32) && check(i64) && check(u32) && check(i16) && check(f64) && check(f32) && check(same) && check(tiny);
+}
+
+bool testProjection() {
+    const int N = 200000;
+    std::vector<Event> a(N);
+    for (int i = 0; i < N; i++) a[i] = {(long long) (rand64() % 5000) - 2500, i};
+    std::vector<Event> b = a;
+    std::stable_sort(b.begin(), b.end(), [](const Event &x, const Event &y) { return x.time < y.time; });
+    sjtu::radix_sort(a.begin(), a.end(), [](const Event &e) { return e.time; });
+    for (int i = 0; i < N; i++) {
+        if (a[i].time != b[i].time || a[i].id != b[i].id) return false;
+    }
+    return true;
+}
+
+bool testList() {
+    sjtu::list<double> l;
+    std::vector<double> v;
+    for (int i = 0; i < 1000; i++) {
+        double x = ((long long) rand64() % 1000 - 500) * 0.25;
+        l.push_back(x);
+        v.push_back(x);
+    }
+    l.sort();
+    std::sort(v.begin(), v.end());
+    auto it = l.cbegin();
+    for (double x : v) {
+        if (*it != x) return false;
+        ++it;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << (testKeys() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testProjection() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testList() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
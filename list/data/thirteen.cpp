@@ -0,0 +1,27 @@
+#define SJTU_STATS
+
+#include "list.hpp"
+
+#include <iostream>
+
+bool testNodeAllocations() {
+    sjtu::list<int> l;
+    for (int i = 0; i < 50; i++) l.push_back(i);
+    for (int i = 0; i < 50; i++) l.push_front(i);
+    l.insert(l.begin(), 7);
+    // one node per element, the sentinels are part of the list
+    sjtu::list<int>::statistics s = l.stats();
+    if (s.node_allocations != 101) return false;
+    l.reset_stats();
+    l.pop_back();
+    l.sort();
+    l.unique();
+    if (l.stats().node_allocations != 0) return false;
+    sjtu::list<int> copy(l);
+    return copy.stats().node_allocations == l.size() && copy.stats().bytes_allocated > 0;
+}
+
+int main() {
+    std::cout << (testNodeAllocations() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
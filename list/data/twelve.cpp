@@ -0,0 +1,51 @@
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include "algorithm.hpp"
+
+unsigned seed = 271828;
+
+int rand() {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 1);
+}
+
+template<class Compare>
+bool check(const std::vector<int> &keys, const std::vector<int> &queries, Compare cmp) {
+    std::vector<long long> lo, hi;
+    sjtu::lower_bound_batch(keys.begin(), keys.end(), queries.begin(), queries.end(), std::back_inserter(lo), cmp);
+    sjtu::upper_bound_batch(keys.data(), keys.data() + keys.size(), queries.begin(), queries.end(),
+                            std::back_inserter(hi), cmp);
+    if (lo.size() != queries.size() || hi.size() != queries.size()) return false;
+    for (size_t i = 0; i < queries.size(); i++) {
+        if (lo[i] != std::lower_bound(keys.begin(), keys.end(), queries[i], cmp) - keys.begin()) return false;
+        if (hi[i] != std::upper_bound(keys.begin(), keys.end(), queries[i], cmp) - keys.begin()) return false;
+    }
+    return true;
+}
+
+bool testBatch() {
+    for (int n : {0, 1, 5, 16, 1000, 300000}) {
+        std::vector<int> keys(n), queries(5000);
+        for (int &x : keys) x = rand() % (n + 10);
+        for (int &x : queries) x = rand() % (n + 20) - 5;
+        std::sort(keys.begin(), keys.end());
+        if (!check(keys, queries, std::less<int>())) return false;
+        // sorted queries take the galloping path
+        std::sort(queries.begin(), queries.end());
+        if (!check(keys, queries, std::less<int>())) return false;
+        std::reverse(keys.begin(), keys.end());
+        if (!check(keys, queries, std::greater<int>())) return false;
+    }
+    std::vector<int> keys = {1, 2, 2, 3}, none;
+    std::vector<long long> out;
+    sjtu::lower_bound_batch(keys.begin(), keys.end(), none.begin(), none.end(), std::back_inserter(out));
+    return out.empty();
+}
+
+int main() {
+    std::cout << (testBatch() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -6,6 +6,7 @@
 
 #include <climits>
 #include <cstddef>
+#include <utility>
 
 namespace sjtu {
 /**
@@ -14,6 +15,17 @@ namespace sjtu {
  */
     template<typename T>
     class list {
+    public:
+        /**
+         * counters kept when compiled with SJTU_STATS defined, all zero otherwise.
+         * SJTU_STATS changes the class layout: define it in every translation unit or in none.
+         * every node is two allocations: the node and its value.
+         */
+        struct statistics {
+            size_t node_allocations = 0;
+            size_t bytes_allocated = 0;
+        };
+
     protected:
         class node {
         public:
@@ -25,7 +37,10 @@ namespace sjtu {
             node *next;
             std::allocator<T> alloc;
 
-            node() : pre(nullptr), next(nullptr) { _data = alloc.allocate(1); }
+            /**
+             * a sentinel, it holds no value
+             */
+            node() : _data(nullptr), pre(nullptr), next(nullptr) {}
             node(const T &value) : pre(nullptr), next(nullptr) {
                 _data = alloc.allocate(1);
                 alloc.construct(_data, value);
@@ -35,6 +50,7 @@ namespace sjtu {
                 alloc.construct(_data, *(copy._data));
             }
             ~node() {
+                if (_data == nullptr) return;
                 if (pre != nullptr && next != nullptr) alloc.destroy(_data);
                 alloc.deallocate(_data, 1);
             }
@@ -43,10 +59,48 @@ namespace sjtu {
     protected:
         /**
          * add data members for linked list as protected members
+         * the sentinels live in the list itself, so an empty list allocates nothing
+         * and a move only relinks the first and the last node.
          */
+        node head_node, tail_node;
         node *head;
         node *tail;
         int _size;
+#ifdef SJTU_STATS
+        statistics _stats;
+#endif
+
+        void init_sentinels() {
+            head = &head_node;
+            tail = &tail_node;
+            head->next = tail;
+            tail->pre = head;
+            _size = 0;
+        }
+        /**
+         * take the nodes of other, which is left empty. this list must be empty.
+         */
+        void steal(list &other) {
+            if (other._size == 0) return;
+            head->next = other.head->next;
+            head->next->pre = head;
+            tail->pre = other.tail->pre;
+            tail->pre->next = tail;
+            _size = other._size;
+            other.head->next = other.tail;
+            other.tail->pre = other.head;
+            other._size = 0;
+        }
+        node *new_node(const T &value) {
+            note_node();
+            return new node(value);
+        }
+        void note_node() {
+#ifdef SJTU_STATS
+            _stats.node_allocations++;
+            _stats.bytes_allocated += sizeof(node) + sizeof(T);
+#endif
+        }
         /**
          * insert node cur before node pos
          * return the inserted node cur
@@ -220,20 +274,13 @@ namespace sjtu {
          * Atleast two: default constructor, copy constructor
          */
         list() {
-            head = new node;
-            tail = new node;
-            head->next = tail;
-            tail->pre = head;
-            _size = 0;
+            init_sentinels();
         }
         list(const list &other) {
-            head = new node;
-            tail = new node;
-            tail->pre = head;
-            head->next = tail;
+            init_sentinels();
             node *copy = other.head->next;
             for (; copy != other.tail; copy = copy->next) {
-                node *p = new node(*(copy->_data));
+                node *p = new_node(*(copy->_data));
                 tail->pre->next = p;
                 p->pre = tail->pre;
                 p->next = tail;
@@ -244,10 +291,16 @@ namespace sjtu {
         /**
          * TODO Destructor
          */
+        /**
+         * O(1), other is left empty. iterators into other are invalidated,
+         * the nodes they point to now belong to this list.
+         */
+        list(list &&other) noexcept {
+            init_sentinels();
+            steal(other);
+        }
         virtual ~list() {
-            for (node *p = head->next; p != nullptr; p = p->next) delete p->pre;
-            delete tail;
-            _size = 0;
+            clear();
         }
         /**
          * TODO Assignment operator
@@ -256,11 +309,25 @@ namespace sjtu {
             if (&other == this) return *this;
             clear();
             for (const_iterator it = other.cbegin(); it != other.cend(); it++) {
-                node *p = new node(*it);
+                node *p = new_node(*it);
                 insert(tail, p);
             }
             return *this;
         }
+        list &operator=(list &&other) noexcept {
+            if (&other == this) return *this;
+            clear();
+            steal(other);
+            return *this;
+        }
+        /**
+         * O(1), iterators into both lists are invalidated.
+         */
+        void swap(list &other) noexcept {
+            list tmp(std::move(other));
+            other.steal(*this);
+            steal(tmp);
+        }
         /**
          * access the first / last element
          * throw container_is_empty when the container is empty.
@@ -295,7 +362,11 @@ namespace sjtu {
          * clears the contents
          */
         virtual void clear() {
-            for (node *p = head->next->next; p != nullptr; p = p->next) delete p->pre;
+            for (node *p = head->next; p != tail;) {
+                node *q = p->next;
+                delete p;
+                p = q;
+            }
             head->next = tail;
             tail->pre = head;
             _size = 0;
@@ -307,7 +378,7 @@ namespace sjtu {
          */
         virtual iterator insert(iterator pos, const T &value) {
             if (pos.GetIt() == head || pos.GetHead() != head) throw sjtu::invalid_iterator();
-            node *p = new node(value);
+            node *p = new_node(value);
             return iterator(insert(pos.GetIt(), p), head);
         }
         /**
@@ -326,7 +397,7 @@ namespace sjtu {
          * adds an element to the end
          */
         void push_back(const T &value) {
-            node *p = new node(value);
+            node *p = new_node(value);
             insert(tail, p);
         }
         /**
@@ -341,7 +412,7 @@ namespace sjtu {
          * inserts an element to the beginning.
          */
         void push_front(const T &value) {
-            node *p = new node(value);
+            node *p = new_node(value);
             insert(head->next, p);
         }
         /**
@@ -354,6 +425,7 @@ namespace sjtu {
         }
         /**
          * sort the values in ascending order with operator< of T
+         * (integral and floating point values are radix sorted)
          */
         void sort() {
             if (_size == 0 || _size == 1) return;
@@ -364,7 +436,7 @@ namespace sjtu {
                 alloc.construct(move + i, *(p->_data));
                 p = p->next;
             }
-            sjtu::sort<T>(move, move + _size, [](const T &a, const T &b) -> bool { return a < b; });
+            sjtu::sort(move, move + _size);
             p = head->next;
             for (int i = 0; i < _size; i++) {
                 p->alloc.destroy(p->_data);
@@ -451,7 +523,26 @@ namespace sjtu {
                 }
             }
         }
+
+        statistics stats() const {
+#ifdef SJTU_STATS
+            return _stats;
+#else
+            return statistics();
+#endif
+        }
+
+        void reset_stats() {
+#ifdef SJTU_STATS
+            _stats = statistics();
+#endif
+        }
     };
+
+    template<typename T>
+    void swap(list<T> &a, list<T> &b) noexcept {
+        a.swap(b);
+    }
 }
 
 #endif //SJTU_LIST_HPP
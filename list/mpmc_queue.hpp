@@ -0,0 +1,249 @@
+#ifndef SJTU_MPMC_QUEUE_HPP
+#define SJTU_MPMC_QUEUE_HPP
+
+#include "exceptions.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+    /**
+     * a bounded lock-free queue for any number of producer and consumer threads,
+     * after Dmitry Vyukov's bounded MPMC queue.
+     * every cell of the ring (capacity rounded up to a power of two, at least 2) carries
+     * a sequence number telling which lap of which side may use it next: a push claims
+     * the tail index with a compare-and-swap once its cell is free for that lap, builds
+     * the element and bumps the sequence; a pop does the same at the head. the batch
+     * calls claim a run of ready cells with one compare-and-swap.
+     * the try_ calls and the batch calls never block: they return false, or how many
+     * elements they moved, instead. push() throws runtime_error on a full queue and
+     * pop() throws container_is_empty on an empty one.
+     */
+    template<typename T>
+    class mpmc_queue {
+        static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+                      "a claimed cell must be filled and emptied without throwing");
+
+    private:
+        static const size_t line = 64;
+
+        struct cell {
+            std::atomic<size_t> sequence;
+            alignas(T) unsigned char value[sizeof(T)];
+
+            T *get() { return reinterpret_cast<T *>(value); }
+        };
+
+        cell *_cells;
+        size_t _mask;
+
+        /**
+         * the next index to push and to pop, each on its own cache line
+         */
+        alignas(line) std::atomic<size_t> _tail;
+        alignas(line) std::atomic<size_t> _head;
+
+        static size_t round_up(size_t n) {
+            size_t capacity = 2;
+            while (capacity < n) capacity <<= 1;
+            return capacity;
+        }
+
+        /**
+         * claim up to want consecutive indices from pos, whose cells must show sequence
+         * pos + i + lag; returns the first one in pos and the number claimed, 0 when the
+         * cell at the index is not ready (full for pushes, empty for pops).
+         */
+        size_t claim(std::atomic<size_t> &index, size_t lag, size_t want, size_t &pos) {
+            pos = index.load(std::memory_order_relaxed);
+            for (;;) {
+                size_t n = 0;
+                for (; n < want; n++) {
+                    size_t seq = _cells[(pos + n) & _mask].sequence.load(std::memory_order_acquire);
+                    if (seq != pos + n + lag) break;
+                }
+                if (n == 0) {
+                    size_t seq = _cells[pos & _mask].sequence.load(std::memory_order_acquire);
+                    // behind: the cell still holds last lap's element (or is still empty)
+                    if ((std::ptrdiff_t) (seq - (pos + lag)) < 0) return 0;
+                    pos = index.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (index.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) return n;
+            }
+        }
+
+        T *slot(size_t pos) {
+            return _cells[pos & _mask].get();
+        }
+
+        /**
+         * hand the cell of pos to the pop of pos
+         */
+        void filled(size_t pos) {
+            _cells[pos & _mask].sequence.store(pos + 1, std::memory_order_release);
+        }
+
+        /**
+         * hand the cell of pos to the push one lap later
+         */
+        void emptied(size_t pos) {
+            _cells[pos & _mask].sequence.store(pos + _mask + 1, std::memory_order_release);
+        }
+
+        /**
+         * the claimed cells [pos + done, pos + n) of a pop_batch; whatever is left when
+         * the batch ends, e.g. because the output threw, is destroyed and handed back,
+         * so that no producer waits for those cells forever.
+         */
+        struct claimed {
+            mpmc_queue &q;
+            size_t pos, done, n;
+
+            ~claimed() {
+                for (; done < n; done++) {
+                    q.slot(pos + done)->~T();
+                    q.emptied(pos + done);
+                }
+            }
+        };
+
+    public:
+        /**
+         * a queue of at least capacity slots; throws runtime_error if capacity is 0.
+         */
+        explicit mpmc_queue(size_t capacity) : _tail(0), _head(0) {
+            if (capacity == 0) throw sjtu::runtime_error();
+            capacity = round_up(capacity);
+            _cells = static_cast<cell *>(::operator new(capacity * sizeof(cell), std::align_val_t(line)));
+            for (size_t i = 0; i < capacity; i++) new(&_cells[i].sequence) std::atomic<size_t>(i);
+            _mask = capacity - 1;
+        }
+
+        mpmc_queue(const mpmc_queue &) = delete;
+
+        mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+        ~mpmc_queue() {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            for (size_t i = _head.load(std::memory_order_relaxed); i != tail; i++) slot(i)->~T();
+            ::operator delete(_cells, std::align_val_t(line));
+        }
+
+        /**
+         * build an element and push it, return false if the queue is full.
+         * the element is built before a cell is claimed, so a throwing constructor
+         * leaves the queue untouched.
+         */
+        template<class... Args>
+        bool try_emplace(Args &&... args) {
+            T value(std::forward<Args>(args)...);
+            size_t pos;
+            if (claim(_tail, 0, 1, pos) == 0) return false;
+            new(slot(pos)) T(std::move(value));
+            filled(pos);
+            return true;
+        }
+
+        bool try_push(const T &value) {
+            return try_emplace(value);
+        }
+
+        bool try_push(T &&value) {
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * push value, throw runtime_error if the queue is full.
+         */
+        void push(const T &value) {
+            if (!try_emplace(value)) throw sjtu::runtime_error();
+        }
+
+        void push(T &&value) {
+            if (!try_emplace(std::move(value))) throw sjtu::runtime_error();
+        }
+
+        /**
+         * push the first n elements from first, or as many consecutive free cells as
+         * one claim gets; return how many were pushed. the elements are moved from *first.
+         */
+        template<class ForwardIt>
+        size_t push_batch(ForwardIt first, size_t n) {
+            if (n == 0) return 0;
+            size_t pos;
+            n = claim(_tail, 0, n, pos);
+            for (size_t i = 0; i < n; i++, ++first) {
+                new(slot(pos + i)) T(std::move(*first));
+                filled(pos + i);
+            }
+            return n;
+        }
+
+        /**
+         * move the head into out, return false if the queue is empty.
+         */
+        bool try_pop(T &out) {
+            size_t pos;
+            if (claim(_head, 1, 1, pos) == 0) return false;
+            out = std::move(*slot(pos));
+            slot(pos)->~T();
+            emptied(pos);
+            return true;
+        }
+
+        /**
+         * pop and return the head, throw container_is_empty if there is none.
+         */
+        T pop() {
+            size_t pos;
+            if (claim(_head, 1, 1, pos) == 0) throw sjtu::container_is_empty();
+            T ret(std::move(*slot(pos)));
+            slot(pos)->~T();
+            emptied(pos);
+            return ret;
+        }
+
+        /**
+         * move up to max elements to out (*out++ = element), as many consecutive full
+         * cells as one claim gets; return how many were popped.
+         * if the output throws, the claimed elements not written yet are dropped.
+         */
+        template<class OutputIt>
+        size_t pop_batch(OutputIt out, size_t max) {
+            if (max == 0) return 0;
+            size_t pos;
+            size_t n = claim(_head, 1, max, pos);
+            claimed cells{*this, pos, 0, n};
+            for (; cells.done < n; cells.done++, ++out) {
+                T *p = slot(pos + cells.done);
+                *out = std::move(*p);
+                p->~T();
+                emptied(pos + cells.done);
+            }
+            return n;
+        }
+
+        /**
+         * the number of claimed elements; only a snapshot while other threads are running.
+         */
+        size_t size() const {
+            size_t head = _head.load(std::memory_order_acquire);
+            size_t tail = _tail.load(std::memory_order_acquire);
+            return tail - head > _mask + 1 ? _mask + 1 : tail - head;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        size_t capacity() const {
+            return _mask + 1;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef SJTU_PARALLEL_SORT_HPP
+#define SJTU_PARALLEL_SORT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include "algorithm.hpp"
+
+namespace sjtu{
+
+    namespace detail{
+
+        /**
+         * ranges shorter than this are sorted sequentially
+         */
+        const std::ptrdiff_t parallel_cutoff = 1 << 15;
+
+        /**
+         * a fixed set of workers, each with its own task deque.
+         * a worker pops its own deque from the back and steals from the front of the others.
+         * the thread that owns the pool is worker 0 and runs tasks while waiting.
+         */
+        class task_pool{
+        private:
+            struct alignas(64) task_queue{
+                std::mutex lock;
+                std::deque<std::function<void()>> tasks;
+            };
+
+            task_queue *queues;
+            std::thread *workers;
+            std::size_t n;
+            std::atomic<bool> stop;
+
+            struct identity{
+                const task_pool *pool;
+                std::size_t id;
+            };
+
+            static identity &self(){
+                thread_local identity who = {nullptr, 0};
+                return who;
+            }
+
+            std::size_t index() const { return self().pool == this ? self().id : 0; }
+
+            bool take(std::size_t i, bool back, std::function<void()> &task){
+                std::lock_guard<std::mutex> guard(queues[i].lock);
+                if (queues[i].tasks.empty()) return false;
+                if (back){
+                    task = std::move(queues[i].tasks.back());
+                    queues[i].tasks.pop_back();
+                } else {
+                    task = std::move(queues[i].tasks.front());
+                    queues[i].tasks.pop_front();
+                }
+                return true;
+            }
+
+        public:
+            explicit task_pool(std::size_t threads) : n(threads < 1 ? 1 : threads), stop(false){
+                queues = new task_queue[n];
+                workers = new std::thread[n - 1];
+                for (std::size_t i = 1; i < n; i++){
+                    workers[i - 1] = std::thread([this, i](){
+                        self().pool = this;
+                        self().id = i;
+                        while (!stop.load(std::memory_order_acquire)){
+                            if (!run_one()) std::this_thread::yield();
+                        }
+                    });
+                }
+            }
+
+            task_pool(const task_pool &) = delete;
+            task_pool &operator=(const task_pool &) = delete;
+
+            ~task_pool(){
+                stop.store(true, std::memory_order_release);
+                for (std::size_t i = 0; i + 1 < n; i++) workers[i].join();
+                delete[] workers;
+                delete[] queues;
+            }
+
+            std::size_t size() const { return n; }
+
+            void spawn(std::function<void()> task){
+                task_queue &q = queues[index()];
+                std::lock_guard<std::mutex> guard(q.lock);
+                q.tasks.push_back(std::move(task));
+            }
+
+            /**
+             * run one task from the own deque or a stolen one, false if there was none.
+             */
+            bool run_one(){
+                std::size_t me = index();
+                std::function<void()> task;
+                bool found = take(me, true, task);
+                for (std::size_t k = 1; !found && k < n; k++) found = take((me + k) % n, false, task);
+                if (found) task();
+                return found;
+            }
+        };
+
+        /**
+         * fork-join on a task_pool: wait() runs tasks until every spawned one has finished.
+         */
+        class task_group{
+        private:
+            task_pool &pool;
+            std::atomic<std::size_t> left;
+        public:
+            explicit task_group(task_pool &p) : pool(p), left(0) {}
+
+            template<class F>
+            void spawn(F f){
+                left++;
+                pool.spawn([this, f]() mutable {
+                    f();
+                    left--;
+                });
+            }
+
+            void wait(){
+                while (left.load() > 0){
+                    if (!pool.run_one()) std::this_thread::yield();
+                }
+            }
+        };
+
+        /**
+         * introsort that hands the shorter side of every long partition to the pool.
+         */
+        template<class RandomIt, class Compare>
+        void parallel_introsort(task_group &group, RandomIt begin, RandomIt end, int depth, Compare &cmp){
+            while (end - begin > parallel_cutoff){
+                if (depth == 0){
+                    detail::heap_sort(begin, end, cmp);
+                    return ;
+                }
+                depth--;
+                detail::move_pivot_to_begin(begin, end, cmp);
+                RandomIt cut = detail::partition(begin, end, cmp);
+                RandomIt a = begin, b = cut;
+                if (cut - begin < end - cut) begin = cut;
+                else a = cut, b = end, end = cut;
+                group.spawn([&group, a, b, depth, &cmp](){ detail::parallel_introsort(group, a, b, depth, cmp); });
+            }
+            detail::introsort(begin, end, depth, cmp);
+        }
+
+        /**
+         * merge sort whose halves run as separate tasks, buf holds end - begin elements.
+         */
+        template<class RandomIt, class BufIt, class Compare>
+        void parallel_merge_sort(task_pool &pool, RandomIt begin, RandomIt end, BufIt buf, Compare &cmp){
+            std::ptrdiff_t len = end - begin;
+            if (len <= parallel_cutoff){
+                detail::merge_sort(begin, end, buf, cmp);
+                return ;
+            }
+            RandomIt mid = begin + len / 2;
+            task_group halves(pool);
+            halves.spawn([&pool, begin, mid, buf, &cmp](){ detail::parallel_merge_sort(pool, begin, mid, buf, cmp); });
+            detail::parallel_merge_sort(pool, mid, end, buf + len / 2, cmp);
+            halves.wait();
+            if (!cmp(*mid, *(mid - 1))) return ;
+            detail::merge_with_buffer(begin, mid, end, buf, cmp);
+        }
+    }
+
+    /**
+     * samplesort on a work-stealing pool of threads workers (0 for one per hardware thread).
+     * the elements are classified into buckets by sampled splitters and scattered block by
+     * block in parallel, then each bucket is sorted as its own task: by a parallel introsort,
+     * or with stable set by a parallel merge sort, which keeps equal elements in input order.
+     * ranges shorter than parallel_cutoff are sorted sequentially.
+     * cmp is shared by all the workers, so it must be safe to call concurrently and must not throw.
+     */
+    template<class RandomIt, class Compare>
+    void parallel_sort(RandomIt begin, RandomIt end, Compare cmp, unsigned threads = 0, bool stable = false){
+        typedef detail::value_t<RandomIt> T;
+        std::ptrdiff_t n = end - begin;
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads <= 1 || n <= detail::parallel_cutoff){
+            if (stable) sjtu::stable_sort(begin, end, cmp);
+            else sjtu::sort(begin, end, cmp);
+            return ;
+        }
+        detail::task_pool pool(threads);
+        detail::task_group group(pool);
+
+        std::size_t bucket_num = threads * 8, oversample = 16;
+        if (bucket_num > 1024) bucket_num = 1024;
+        detail::raw_buffer<T> splitters(bucket_num * oversample);
+        for (std::size_t i = 0; i < bucket_num * oversample; i++)
+            splitters.push_back(*(begin + (std::ptrdiff_t) (i * n / (bucket_num * oversample))));
+        sjtu::sort(splitters.data(), splitters.data() + splitters.size(), cmp);
+        for (std::size_t i = 1; i < bucket_num; i++) splitters.data()[i - 1] = splitters.data()[i * oversample];
+        T *split_begin = splitters.data(), *split_end = splitters.data() + (bucket_num - 1);
+
+        // classify every block and move it into buf, counting the bucket sizes per block
+        std::size_t block_num = threads;
+        std::ptrdiff_t block = (n + block_num - 1) / block_num;
+        std::unique_ptr<std::uint16_t[]> bucket_array(new std::uint16_t[n]);
+        std::unique_ptr<std::size_t[]> count_array(new std::size_t[block_num * bucket_num]());
+        std::uint16_t *bucket_of = bucket_array.get();
+        std::size_t *count = count_array.get();
+        detail::raw_buffer<T> buf(n);
+        for (std::size_t p = 0; p < block_num; p++){
+            group.spawn([=, &buf, &cmp](){
+                std::size_t *cnt = count + p * bucket_num;
+                std::ptrdiff_t last = (std::ptrdiff_t) (p + 1) * block < n ? (std::ptrdiff_t) (p + 1) * block : n;
+                for (std::ptrdiff_t i = p * block; i < last; i++){
+                    RandomIt it = begin + i;
+                    bucket_of[i] = (std::uint16_t) (sjtu::upper_bound(split_begin, split_end, *it, cmp) - split_begin);
+                    cnt[bucket_of[i]]++;
+                    new (buf.data() + i) T(std::move(*it));
+                }
+            });
+        }
+        group.wait();
+        buf.set_size(n);
+
+        // exclusive prefix sums in (bucket, block) order keep the scatter stable
+        std::unique_ptr<std::ptrdiff_t[]> bucket_start(new std::ptrdiff_t[bucket_num + 1]);
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < bucket_num; b++){
+            bucket_start[b] = sum;
+            for (std::size_t p = 0; p < block_num; p++){
+                std::size_t c = count[p * bucket_num + b];
+                count[p * bucket_num + b] = sum;
+                sum += c;
+            }
+        }
+        bucket_start[bucket_num] = n;
+        for (std::size_t p = 0; p < block_num; p++){
+            group.spawn([=, &buf](){
+                std::size_t *offset = count + p * bucket_num;
+                std::ptrdiff_t last = (std::ptrdiff_t) (p + 1) * block < n ? (std::ptrdiff_t) (p + 1) * block : n;
+                for (std::ptrdiff_t i = p * block; i < last; i++)
+                    *(begin + (std::ptrdiff_t) offset[bucket_of[i]]++) = std::move(buf.data()[i]);
+            });
+        }
+        group.wait();
+
+        for (std::size_t b = 0; b < bucket_num; b++){
+            RandomIt l = begin + bucket_start[b], r = begin + bucket_start[b + 1];
+            if (r - l <= 1) continue;
+            T *scratch = buf.data() + bucket_start[b];
+            group.spawn([&pool, &group, l, r, scratch, stable, &cmp](){
+                if (stable) detail::parallel_merge_sort(pool, l, r, scratch, cmp);
+                else detail::parallel_introsort(group, l, r, 2 * detail::floor_log2(r - l), cmp);
+            });
+        }
+        group.wait();
+    }
+
+    template<class RandomIt>
+    void parallel_sort(RandomIt begin, RandomIt end){
+        sjtu::parallel_sort(begin, end, std::less<detail::value_t<RandomIt>>());
+    }
+
+};
+
+#endif //SJTU_PARALLEL_SORT_HPP
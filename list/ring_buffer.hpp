@@ -0,0 +1,602 @@
+#ifndef SJTU_RING_BUFFER_HPP
+#define SJTU_RING_BUFFER_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace sjtu {
+    /**
+     * a double-ended queue in one circular array, for FIFO work that would otherwise
+     * pay a node per element in sjtu::list: push and pop at both ends are amortized
+     * O(1) and element i lives at slot (head + i) & (capacity - 1), the capacity being
+     * a power of two.
+     * a default constructed ring_buffer grows by doubling; ring_buffer(window) keeps at
+     * most window elements and never reallocates, a push onto a full one overwrites
+     * the element at the other end (the oldest, for push_back).
+     * the iterators are random access like vector's and are invalidated by any push
+     * that reallocates or overwrites and by pops of the element they point at.
+     */
+    template<typename T>
+    class ring_buffer {
+    public:
+        /**
+         * counters kept when compiled with SJTU_STATS defined, all zero otherwise.
+         * SJTU_STATS changes the class layout: define it in every translation unit or in none.
+         * overwrites counts the elements dropped by pushes onto a full window.
+         */
+        struct statistics {
+            size_t allocations = 0;
+            size_t bytes_allocated = 0;
+            size_t reallocations = 0;
+            size_t moves = 0;
+            size_t overwrites = 0;
+        };
+
+    private:
+        std::allocator<T> alloc;
+        T *_data;
+        size_t _capacity;
+        size_t _mask;
+        size_t _head;
+        size_t _size;
+        size_t _window;  // 0 when unbounded
+#ifdef SJTU_STATS
+        statistics _stats;
+#endif
+
+        static size_t round_up(size_t n) {
+            size_t capacity = 1;
+            while (capacity < n) capacity <<= 1;
+            return capacity;
+        }
+
+        void note_allocation(size_t n) {
+#ifdef SJTU_STATS
+            _stats.allocations++;
+            _stats.bytes_allocated += n * sizeof(T);
+#else
+            (void) n;
+#endif
+        }
+
+        void note_overwrite() {
+#ifdef SJTU_STATS
+            _stats.overwrites++;
+#endif
+        }
+
+        T *slot(size_t i) const {
+            return _data + ((_head + i) & _mask);
+        }
+
+        /**
+         * move the elements to the start of fresh, free the old array and adopt fresh.
+         * the old elements are destroyed only once all of them are in fresh: if a copy
+         * throws, the copies made so far are destroyed and the buffer is left as it was,
+         * fresh is still the caller's to free.
+         */
+        void relocate(T *fresh, size_t capacity) {
+            size_t built = 0;
+            try {
+                for (; built < _size; built++) alloc.construct(fresh + built, std::move_if_noexcept(*slot(built)));
+            } catch (...) {
+                for (size_t i = 0; i < built; i++) alloc.destroy(fresh + i);
+                throw;
+            }
+#ifdef SJTU_STATS
+            _stats.reallocations++;
+            _stats.moves += _size;
+#endif
+            for (size_t i = 0; i < _size; i++) alloc.destroy(slot(i));
+            if (_data != nullptr) alloc.deallocate(_data, _capacity);
+            _data = fresh;
+            _capacity = capacity;
+            _mask = capacity - 1;
+            _head = 0;
+        }
+
+        /**
+         * double the capacity and build the new element at the front or the back;
+         * it is built before the others move, since args may live in the old array.
+         */
+        template<class... Args>
+        T &grow_emplace(bool front, Args &&... args) {
+            size_t capacity = _capacity == 0 ? 8 : _capacity * 2;
+            T *fresh = alloc.allocate(capacity);
+            note_allocation(capacity);
+            T *p = fresh + (front ? capacity - 1 : _size);
+            try {
+                alloc.construct(p, std::forward<Args>(args)...);
+            } catch (...) {
+                alloc.deallocate(fresh, capacity);
+                throw;
+            }
+            try {
+                relocate(fresh, capacity);
+            } catch (...) {
+                alloc.destroy(p);
+                alloc.deallocate(fresh, capacity);
+                throw;
+            }
+            if (front) _head = _mask;
+            _size++;
+            return *p;
+        }
+
+        /**
+         * push onto a full window: the new element takes the place of the one at the
+         * other end, reusing its slot when the window fills the whole array.
+         */
+        template<class... Args>
+        T &overwrite_emplace(bool front, Args &&... args) {
+            note_overwrite();
+            T *victim = front ? slot(_size - 1) : slot(0);
+            T *p = front ? slot(_mask) : slot(_size);
+            if (p == victim) {
+                *p = T(std::forward<Args>(args)...);
+            } else {
+                alloc.construct(p, std::forward<Args>(args)...);
+                alloc.destroy(victim);
+            }
+            _head = (_head + (front ? _mask : 1)) & _mask;
+            return *p;
+        }
+
+        template<class... Args>
+        T &emplace(bool front, Args &&... args) {
+            if (full()) return overwrite_emplace(front, std::forward<Args>(args)...);
+            if (_size == _capacity) return grow_emplace(front, std::forward<Args>(args)...);
+            T *p = front ? slot(_mask) : slot(_size);
+            alloc.construct(p, std::forward<Args>(args)...);
+            if (front) _head = (_head + _mask) & _mask;
+            _size++;
+            return *p;
+        }
+
+    public:
+        class const_iterator;
+
+        class iterator {
+            friend class ring_buffer;
+            friend class const_iterator;
+
+        private:
+            T *_data;
+            size_t _mask;
+            size_t _pos;  // head + index, masked on access
+
+            iterator(T *data, size_t mask, size_t pos) : _data(data), _mask(mask), _pos(pos) {}
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef T * pointer;
+            typedef T & reference;
+
+            iterator() : _data(nullptr), _mask(0), _pos(0) {}
+
+            iterator operator+(const int &n) const {
+                return iterator(_data, _mask, _pos + n);
+            }
+
+            iterator operator-(const int &n) const {
+                return iterator(_data, _mask, _pos - n);
+            }
+
+            int operator-(const iterator &rhs) const {
+                if (_data != rhs._data) throw sjtu::invalid_iterator();
+                return (int) (_pos - rhs._pos);
+            }
+
+            iterator &operator+=(const int &n) {
+                _pos += n;
+                return *this;
+            }
+
+            iterator &operator-=(const int &n) {
+                _pos -= n;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator tmp = *this;
+                _pos++;
+                return tmp;
+            }
+
+            iterator &operator++() {
+                _pos++;
+                return *this;
+            }
+
+            iterator operator--(int) {
+                iterator tmp = *this;
+                _pos--;
+                return tmp;
+            }
+
+            iterator &operator--() {
+                _pos--;
+                return *this;
+            }
+
+            T & operator*() const {
+                return _data[_pos & _mask];
+            }
+
+            T * operator->() const {
+                return _data + (_pos & _mask);
+            }
+
+            T & operator[](const int &n) const {
+                return _data[(_pos + n) & _mask];
+            }
+
+            bool operator<(const iterator &rhs) const {
+                return _pos < rhs._pos;
+            }
+
+            bool operator>(const iterator &rhs) const {
+                return _pos > rhs._pos;
+            }
+
+            bool operator<=(const iterator &rhs) const {
+                return _pos <= rhs._pos;
+            }
+
+            bool operator>=(const iterator &rhs) const {
+                return _pos >= rhs._pos;
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return _data == rhs._data && _pos == rhs._pos;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return _data == rhs._data && _pos == rhs._pos;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        class const_iterator {
+            friend class ring_buffer;
+            friend class iterator;
+
+        private:
+            const T *_data;
+            size_t _mask;
+            size_t _pos;
+
+            const_iterator(const T *data, size_t mask, size_t pos) : _data(data), _mask(mask), _pos(pos) {}
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T * pointer;
+            typedef const T & reference;
+
+            const_iterator() : _data(nullptr), _mask(0), _pos(0) {}
+
+            const_iterator(const iterator &other) : _data(other._data), _mask(other._mask), _pos(other._pos) {}
+
+            const_iterator operator+(const int &n) const {
+                return const_iterator(_data, _mask, _pos + n);
+            }
+
+            const_iterator operator-(const int &n) const {
+                return const_iterator(_data, _mask, _pos - n);
+            }
+
+            int operator-(const const_iterator &rhs) const {
+                if (_data != rhs._data) throw sjtu::invalid_iterator();
+                return (int) (_pos - rhs._pos);
+            }
+
+            const_iterator &operator+=(const int &n) {
+                _pos += n;
+                return *this;
+            }
+
+            const_iterator &operator-=(const int &n) {
+                _pos -= n;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                _pos++;
+                return tmp;
+            }
+
+            const_iterator &operator++() {
+                _pos++;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                _pos--;
+                return tmp;
+            }
+
+            const_iterator &operator--() {
+                _pos--;
+                return *this;
+            }
+
+            const T & operator*() const {
+                return _data[_pos & _mask];
+            }
+
+            const T * operator->() const {
+                return _data + (_pos & _mask);
+            }
+
+            const T & operator[](const int &n) const {
+                return _data[(_pos + n) & _mask];
+            }
+
+            bool operator<(const const_iterator &rhs) const {
+                return _pos < rhs._pos;
+            }
+
+            bool operator>(const const_iterator &rhs) const {
+                return _pos > rhs._pos;
+            }
+
+            bool operator<=(const const_iterator &rhs) const {
+                return _pos <= rhs._pos;
+            }
+
+            bool operator>=(const const_iterator &rhs) const {
+                return _pos >= rhs._pos;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return _data == rhs._data && _pos == rhs._pos;
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        ring_buffer() : _data(nullptr), _capacity(0), _mask(0), _head(0), _size(0), _window(0) {}
+
+        /**
+         * a window of at most window elements, allocated up front;
+         * throws runtime_error if window is 0.
+         */
+        explicit ring_buffer(size_t window) : ring_buffer() {
+            if (window == 0) throw sjtu::runtime_error();
+            _capacity = round_up(window);
+            _mask = _capacity - 1;
+            _data = alloc.allocate(_capacity);
+            note_allocation(_capacity);
+            _window = window;
+        }
+
+        ring_buffer(const ring_buffer &other) : ring_buffer() {
+            if (other._capacity == 0) return;
+            _data = alloc.allocate(other._capacity);
+            note_allocation(other._capacity);
+            _capacity = other._capacity;
+            _mask = other._mask;
+            _window = other._window;
+            try {
+                for (; _size < other._size; _size++) alloc.construct(_data + _size, *other.slot(_size));
+            } catch (...) {
+                clear();
+                alloc.deallocate(_data, _capacity);
+                throw;
+            }
+        }
+
+        /**
+         * take the array of other, which is left empty and unbounded.
+         */
+        ring_buffer(ring_buffer &&other) noexcept : ring_buffer() {
+            swap(other);
+        }
+
+        ~ring_buffer() {
+            clear();
+            if (_data != nullptr) alloc.deallocate(_data, _capacity);
+        }
+
+        ring_buffer &operator=(const ring_buffer &other) {
+            if (this == &other) return *this;
+            ring_buffer tmp(other);
+            swap(tmp);
+            return *this;
+        }
+
+        ring_buffer &operator=(ring_buffer &&other) noexcept {
+            if (this == &other) return *this;
+            ring_buffer tmp(std::move(other));
+            swap(tmp);
+            return *this;
+        }
+
+        void swap(ring_buffer &other) noexcept {
+            std::swap(_data, other._data);
+            std::swap(_capacity, other._capacity);
+            std::swap(_mask, other._mask);
+            std::swap(_head, other._head);
+            std::swap(_size, other._size);
+            std::swap(_window, other._window);
+        }
+
+        T &at(const size_t &pos) {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return *slot(pos);
+        }
+
+        const T &at(const size_t &pos) const {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return *slot(pos);
+        }
+
+        T &operator[](const size_t &pos) {
+            return at(pos);
+        }
+
+        const T &operator[](const size_t &pos) const {
+            return at(pos);
+        }
+
+        T &front() {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return *slot(0);
+        }
+
+        const T &front() const {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return *slot(0);
+        }
+
+        T &back() {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return *slot(_size - 1);
+        }
+
+        const T &back() const {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return *slot(_size - 1);
+        }
+
+        iterator begin() {
+            return iterator(_data, _mask, _head);
+        }
+
+        const_iterator cbegin() const {
+            return const_iterator(_data, _mask, _head);
+        }
+
+        iterator end() {
+            return iterator(_data, _mask, _head + _size);
+        }
+
+        const_iterator cend() const {
+            return const_iterator(_data, _mask, _head + _size);
+        }
+
+        bool empty() const {
+            return _size == 0;
+        }
+
+        size_t size() const {
+            return _size;
+        }
+
+        size_t capacity() const {
+            return _capacity;
+        }
+
+        /**
+         * the bound given to the constructor, 0 for a growing ring_buffer.
+         */
+        size_t window() const {
+            return _window;
+        }
+
+        bool full() const {
+            return _window != 0 && _size == _window;
+        }
+
+        /**
+         * make room for n elements without reallocating; a window never grows.
+         */
+        void reserve(size_t n) {
+            if (n <= _capacity || _window != 0) return;
+            size_t capacity = round_up(n);
+            T *fresh = alloc.allocate(capacity);
+            note_allocation(capacity);
+            try {
+                relocate(fresh, capacity);
+            } catch (...) {
+                alloc.deallocate(fresh, capacity);
+                throw;
+            }
+        }
+
+        void clear() {
+            for (size_t i = 0; i < _size; i++) alloc.destroy(slot(i));
+            _head = 0;
+            _size = 0;
+        }
+
+        void push_back(const T &value) {
+            emplace(false, value);
+        }
+
+        void push_back(T &&value) {
+            emplace(false, std::move(value));
+        }
+
+        template<class... Args>
+        T &emplace_back(Args &&... args) {
+            return emplace(false, std::forward<Args>(args)...);
+        }
+
+        void push_front(const T &value) {
+            emplace(true, value);
+        }
+
+        void push_front(T &&value) {
+            emplace(true, std::move(value));
+        }
+
+        template<class... Args>
+        T &emplace_front(Args &&... args) {
+            return emplace(true, std::forward<Args>(args)...);
+        }
+
+        void pop_back() {
+            if (_size == 0) throw sjtu::container_is_empty();
+            _size--;
+            alloc.destroy(slot(_size));
+        }
+
+        void pop_front() {
+            if (_size == 0) throw sjtu::container_is_empty();
+            alloc.destroy(slot(0));
+            _head = (_head + 1) & _mask;
+            _size--;
+        }
+
+        statistics stats() const {
+#ifdef SJTU_STATS
+            return _stats;
+#else
+            return statistics();
+#endif
+        }
+
+        void reset_stats() {
+#ifdef SJTU_STATS
+            _stats = statistics();
+#endif
+        }
+    };
+
+    template<typename T>
+    void swap(ring_buffer<T> &a, ring_buffer<T> &b) noexcept {
+        a.swap(b);
+    }
+}
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef SJTU_SPSC_QUEUE_HPP
+#define SJTU_SPSC_QUEUE_HPP
+
+#include "exceptions.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+    /**
+     * a bounded lock-free queue between exactly one producer thread and one consumer
+     * thread, e.g. handing messages from a network thread to a worker.
+     * the elements live in a ring of capacity slots (rounded up to a power of two);
+     * the producer owns the tail index and the consumer the head index, each on its own
+     * cache line with a cached copy of the other one, so a push or a pop touches the
+     * other side's line only when the ring looks full or empty.
+     * the try_ calls and the batch calls never block: they return false, or how many
+     * elements they moved, instead. push() throws runtime_error on a full queue and
+     * pop() throws container_is_empty on an empty one.
+     */
+    template<typename T>
+    class spsc_queue {
+    private:
+        static const size_t line = 64;
+
+        T *_slots;
+        size_t _mask;
+
+        /**
+         * the producer's line: the next index to write and the last head it saw
+         */
+        alignas(line) std::atomic<size_t> _tail;
+        size_t _head_seen;
+
+        /**
+         * the consumer's line: the next index to read and the last tail it saw
+         */
+        alignas(line) std::atomic<size_t> _head;
+        size_t _tail_seen;
+
+        static size_t round_up(size_t n) {
+            size_t capacity = 1;
+            while (capacity < n) capacity <<= 1;
+            return capacity;
+        }
+
+        /**
+         * free slots for the producer, looking at the real head only when fewer than want.
+         */
+        size_t room(size_t tail, size_t want) {
+            size_t free = _mask + 1 - (tail - _head_seen);
+            if (free >= want) return free;
+            _head_seen = _head.load(std::memory_order_acquire);
+            return _mask + 1 - (tail - _head_seen);
+        }
+
+        /**
+         * published elements for the consumer, looking at the real tail only when fewer than want.
+         */
+        size_t ready(size_t head, size_t want) {
+            size_t count = _tail_seen - head;
+            if (count >= want) return count;
+            _tail_seen = _tail.load(std::memory_order_acquire);
+            return _tail_seen - head;
+        }
+
+    public:
+        /**
+         * a queue of at least capacity slots; throws runtime_error if capacity is 0.
+         */
+        explicit spsc_queue(size_t capacity) : _tail(0), _head_seen(0), _head(0), _tail_seen(0) {
+            if (capacity == 0) throw sjtu::runtime_error();
+            capacity = round_up(capacity);
+            _slots = static_cast<T *>(::operator new(capacity * sizeof(T), std::align_val_t(line)));
+            _mask = capacity - 1;
+        }
+
+        spsc_queue(const spsc_queue &) = delete;
+
+        spsc_queue &operator=(const spsc_queue &) = delete;
+
+        ~spsc_queue() {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            for (size_t i = _head.load(std::memory_order_relaxed); i != tail; i++) _slots[i & _mask].~T();
+            ::operator delete(_slots, std::align_val_t(line));
+        }
+
+        /**
+         * producer only: build an element at the tail, return false if the queue is full.
+         */
+        template<class... Args>
+        bool try_emplace(Args &&... args) {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            if (room(tail, 1) == 0) return false;
+            new(_slots + (tail & _mask)) T(std::forward<Args>(args)...);
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const T &value) {
+            return try_emplace(value);
+        }
+
+        bool try_push(T &&value) {
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * producer only: push value, throw runtime_error if the queue is full.
+         */
+        void push(const T &value) {
+            if (!try_emplace(value)) throw sjtu::runtime_error();
+        }
+
+        void push(T &&value) {
+            if (!try_emplace(std::move(value))) throw sjtu::runtime_error();
+        }
+
+        /**
+         * producer only: push the first n elements from first, or as many as fit,
+         * and publish them with one store; return how many were pushed.
+         * the elements are moved from *first.
+         */
+        template<class InputIt>
+        size_t push_batch(InputIt first, size_t n) {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            size_t free = room(tail, n);
+            if (n > free) n = free;
+            size_t done = 0;
+            try {
+                for (; done < n; done++, ++first) new(_slots + ((tail + done) & _mask)) T(std::move(*first));
+            } catch (...) {
+                _tail.store(tail + done, std::memory_order_release);
+                throw;
+            }
+            _tail.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        /**
+         * consumer only: move the head into out, return false if the queue is empty.
+         */
+        bool try_pop(T &out) {
+            size_t head = _head.load(std::memory_order_relaxed);
+            if (ready(head, 1) == 0) return false;
+            T *p = _slots + (head & _mask);
+            out = std::move(*p);
+            p->~T();
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * consumer only: pop and return the head, throw container_is_empty if there is none.
+         */
+        T pop() {
+            size_t head = _head.load(std::memory_order_relaxed);
+            if (ready(head, 1) == 0) throw sjtu::container_is_empty();
+            T *p = _slots + (head & _mask);
+            T ret(std::move(*p));
+            p->~T();
+            _head.store(head + 1, std::memory_order_release);
+            return ret;
+        }
+
+        /**
+         * consumer only: move up to max elements to out (*out++ = element) and free their
+         * slots with one store; return how many were popped.
+         */
+        template<class OutputIt>
+        size_t pop_batch(OutputIt out, size_t max) {
+            size_t head = _head.load(std::memory_order_relaxed);
+            size_t count = ready(head, max);
+            if (count > max) count = max;
+            size_t done = 0;
+            try {
+                for (; done < count; done++, ++out) {
+                    T *p = _slots + ((head + done) & _mask);
+                    *out = std::move(*p);
+                    p->~T();
+                }
+            } catch (...) {
+                _head.store(head + done, std::memory_order_release);
+                throw;
+            }
+            _head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * the number of elements; only a snapshot while the other side is running.
+         */
+        size_t size() const {
+            size_t head = _head.load(std::memory_order_acquire);
+            size_t tail = _tail.load(std::memory_order_acquire);
+            return tail - head > _mask + 1 ? _mask + 1 : tail - head;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        size_t capacity() const {
+            return _mask + 1;
+        }
+    };
+}
+
+#endif
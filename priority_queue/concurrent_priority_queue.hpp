@@ -0,0 +1,167 @@
+#ifndef SJTU_CONCURRENT_PRIORITY_QUEUE_HPP
+#define SJTU_CONCURRENT_PRIORITY_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+
+/**
+ * a thread-safe relaxed priority queue (MultiQueue) made of several
+ * sjtu::priority_queue shards, each guarded by its own mutex.
+ * push goes to a random shard, pop takes the better top of two random shards,
+ * so the popped element is only approximately the top of the whole queue.
+ * in strict mode pop locks every shard and returns the exact top instead.
+ * there is no shared counter: every shard counts its own elements under its lock,
+ * so threads working on different shards touch no common cache line.
+ */
+    template<typename T, class Compare = std::less<T>>
+    class concurrent_priority_queue {
+    private:
+        struct alignas(64) shard {
+            std::mutex lock;
+            priority_queue<T, Compare> pq;
+            size_t count = 0;
+        };
+
+        shard *shards;
+        size_t shard_num;
+        bool strict;
+
+        static uint64_t rand() {
+            static std::atomic<uint64_t> seed_gen(0x9e3779b97f4a7c15ull);
+            thread_local uint64_t state = seed_gen.fetch_add(0x9e3779b97f4a7c15ull) | 1;
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+
+        /**
+         * pop the exact top by locking all the shards in index order.
+         */
+        bool pop_strict(T &out) {
+            for (size_t i = 0; i < shard_num; i++) shards[i].lock.lock();
+            shard *best = nullptr;
+            for (size_t i = 0; i < shard_num; i++) {
+                if (shards[i].pq.empty()) continue;
+                if (best == nullptr || Compare()(best->pq.top(), shards[i].pq.top())) best = shards + i;
+            }
+            if (best != nullptr) {
+                out = best->pq.top();
+                best->pq.pop();
+                best->count--;
+            }
+            for (size_t i = 0; i < shard_num; i++) shards[i].lock.unlock();
+            return best != nullptr;
+        }
+
+        /**
+         * pop the better top of shards a and b (a < b), locked in index order.
+         */
+        bool pop_two(size_t a, size_t b, T &out) {
+            std::lock_guard<std::mutex> la(shards[a].lock);
+            std::lock_guard<std::mutex> lb(shards[b].lock);
+            shard *sa = shards + a, *sb = shards + b;
+            if (sa->count == 0 && sb->count == 0) return false;
+            if (sa->count == 0 || (sb->count != 0 && Compare()(sa->pq.top(), sb->pq.top()))) sa = sb;
+            out = sa->pq.top();
+            sa->pq.pop();
+            sa->count--;
+            return true;
+        }
+
+    public:
+        /**
+         * shard_count defaults to twice the number of hardware threads.
+         */
+        explicit concurrent_priority_queue(size_t shard_count = 0, bool strict_order = false)
+                : shard_num(shard_count), strict(strict_order) {
+            if (shard_num == 0) shard_num = 2 * std::thread::hardware_concurrency();
+            if (shard_num < 2) shard_num = 2;
+            shards = new shard[shard_num];
+        }
+
+        concurrent_priority_queue(const concurrent_priority_queue &) = delete;
+
+        concurrent_priority_queue &operator=(const concurrent_priority_queue &) = delete;
+
+        ~concurrent_priority_queue() { delete[] shards; }
+
+        /**
+         * push new element to a random shard.
+         */
+        void push(const T &e) {
+            shard &s = shards[rand() % shard_num];
+            std::lock_guard<std::mutex> guard(s.lock);
+            s.pq.push(e);
+            s.count++;
+        }
+
+        /**
+         * pop an element into out.
+         * return false if every shard was found empty.
+         */
+        bool try_pop(T &out) {
+            if (strict) return pop_strict(out);
+            size_t a = rand() % shard_num, b = rand() % (shard_num - 1);
+            if (b >= a) b++; else std::swap(a, b);
+            if (pop_two(a, b, out)) return true;
+            // both samples were empty, sweep the rest before giving up
+            for (size_t i = 0; i < shard_num; i++) {
+                std::lock_guard<std::mutex> guard(shards[i].lock);
+                if (shards[i].count == 0) continue;
+                out = shards[i].pq.top();
+                shards[i].pq.pop();
+                shards[i].count--;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * pop and return an element.
+         * throw container_is_empty if every shard is empty.
+         */
+        T pop() {
+            T ret;
+            if (!try_pop(ret)) throw sjtu::container_is_empty();
+            return ret;
+        }
+
+        /**
+         * return the number of the elements, summed shard by shard.
+         * only a snapshot while other threads are pushing or popping.
+         */
+        size_t size() const {
+            size_t total = 0;
+            for (size_t i = 0; i < shard_num; i++) {
+                std::lock_guard<std::mutex> guard(shards[i].lock);
+                total += shards[i].count;
+            }
+            return total;
+        }
+
+        bool empty() const {
+            for (size_t i = 0; i < shard_num; i++) {
+                std::lock_guard<std::mutex> guard(shards[i].lock);
+                if (shards[i].count != 0) return false;
+            }
+            return true;
+        }
+
+        size_t shard_count() const { return shard_num; }
+
+        bool is_strict() const { return strict; }
+    };
+
+}
+
+#endif
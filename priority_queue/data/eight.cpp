@@ -0,0 +1,135 @@
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "priority_queue.hpp"
+
+unsigned seed = 19260817;
+
+int rand() {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 8);
+}
+
+bool testPushBulk() {
+    sjtu::priority_queue<int> pq;
+    std::vector<int> all;
+    for (int round = 0; round < 50; round++) {
+        std::vector<int> batch;
+        for (int i = round * 37 % 1000; i >= 0; i--) batch.push_back(rand() % 100000);
+        pq.push_bulk(batch.begin(), batch.end());
+        pq.push(round);
+        all.insert(all.end(), batch.begin(), batch.end());
+        all.push_back(round);
+    }
+    pq.push_bulk(all.begin(), all.begin());
+    if (pq.size() != all.size()) return false;
+    std::sort(all.begin(), all.end(), std::greater<int>());
+    for (size_t i = 0; i < all.size(); i++, pq.pop()) {
+        if (pq.top() != all[i]) return false;
+    }
+    return pq.empty();
+}
+
+bool testPopWhile() {
+    // timers: the earliest deadline is the top
+    sjtu::priority_queue<int, std::greater<int>> timers;
+    std::vector<int> all;
+    for (int i = 0; i < 100000; i++) all.push_back(rand() % 1000000);
+    timers.push_bulk(all.begin(), all.end());
+    std::sort(all.begin(), all.end());
+    size_t fired = 0;
+    for (int now = 0; now < 1000000 + 4999; now += 4999) {
+        std::vector<int> due;
+        timers.pop_while([now](const int &t) { return t <= now; }, std::back_inserter(due));
+        std::sort(due.begin(), due.end());
+        size_t upto = std::upper_bound(all.begin(), all.end(), now) - all.begin();
+        if (due.size() != upto - fired || !std::equal(due.begin(), due.end(), all.begin() + fired)) return false;
+        fired = upto;
+        if (timers.size() != all.size() - fired) return false;
+        if (!timers.empty() && timers.top() <= now) return false;
+    }
+    return fired == all.size() && timers.empty();
+}
+
+/**
+ * an output iterator that throws on its 101st element
+ */
+struct short_output {
+    std::vector<int> *to;
+
+    short_output &operator*() { return *this; }
+
+    short_output &operator++() { return *this; }
+
+    short_output &operator=(int x) {
+        if (to->size() == 100) throw 1;
+        to->push_back(x);
+        return *this;
+    }
+};
+
+bool testPopWhileThrows() {
+    sjtu::priority_queue<int, std::greater<int>> timers;
+    std::vector<int> all, out;
+    for (int i = 0; i < 10000; i++) all.push_back(rand() % 100000);
+    timers.push_bulk(all.begin(), all.end());
+    int calls = 0, caught = 0;
+    try {
+        timers.pop_while([&calls](const int &t) {
+            if (++calls == 500) throw 0;
+            return t <= 50000;
+        }, std::back_inserter(out));
+    } catch (int) { caught++; }
+    if (out.size() + timers.size() != all.size()) return false;
+    std::vector<int> more;
+    try {
+        timers.pop_while([](const int &t) { return t <= 50000; }, short_output{&more});
+    } catch (int) { caught++; }
+    if (more.size() != 100 || out.size() + more.size() + timers.size() != all.size()) return false;
+    out.insert(out.end(), more.begin(), more.end());
+    // nothing is lost or written twice, and the rest still comes out in order
+    std::vector<int> rest;
+    timers.drain_sorted(std::back_inserter(rest));
+    if (caught != 2 || !std::is_sorted(rest.begin(), rest.end())) return false;
+    out.insert(out.end(), rest.begin(), rest.end());
+    std::sort(out.begin(), out.end());
+    std::sort(all.begin(), all.end());
+    return out == all;
+}
+
+bool testBounded() {
+    sjtu::priority_queue<int> pq(3);
+    int a[] = {5, 1, 9, 7, 3, 8};
+    pq.push_bulk(a, a + 6);
+    std::vector<int> low;
+    // the best kept elements are due, although the worst one is not
+    pq.pop_while([](const int &x) { return x > 7; }, std::back_inserter(low));
+    std::sort(low.begin(), low.end());
+    if (low.size() != 2 || low[0] != 8 || low[1] != 9 || pq.size() != 1 || pq.top() != 7) return false;
+    // a throwing output leaves the elements not written in a valid heap
+    sjtu::priority_queue<int> big(300);
+    for (int i = 0; i < 1000; i++) big.push(i);
+    std::vector<int> more;
+    try {
+        big.pop_while([](const int &x) { return x >= 800; }, short_output{&more});
+        return false;
+    } catch (int) {}
+    if (more.size() != 100 || big.size() != 200 || big.worst() != 700) return false;
+    for (int x = 999; x >= 700; x--) {
+        if (std::find(more.begin(), more.end(), x) != more.end()) continue;
+        if (big.top() != x) return false;
+        big.pop();
+    }
+    return big.empty();
+}
+
+int main() {
+    std::cout << (testPushBulk() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testPopWhile() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testPopWhileThrows() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testBounded() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
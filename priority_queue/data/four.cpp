@@ -18,7 +18,7 @@ void TestConstructorAndPush(){
     int up = 600;
     for (int i = 0;i < up;i ++){
         q.push(i);
-    }5
+    }
     for (int i = 0;i < up / 2;i ++){
         std :: cout << q.top() << " ";
         q.pop();
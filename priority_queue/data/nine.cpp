@@ -0,0 +1,30 @@
+#define SJTU_STATS
+
+#include <iostream>
+#include <vector>
+#include "priority_queue.hpp"
+
+bool testMergeDepth() {
+    sjtu::priority_queue<int> q;
+    for (int i = 0; i < 1000; i++) q.push(i * 7 % 1000);
+    sjtu::priority_queue<int>::statistics s = q.stats();
+    // a leftist heap keeps its right spine at O(log n)
+    if (s.allocations != 1000 || s.merge_steps == 0 || s.max_merge_depth > 2 * 10 + 2) return false;
+    q.reset_stats();
+    while (!q.empty()) q.pop();
+    s = q.stats();
+    return s.allocations == 0 && s.merge_steps > 0 && s.max_merge_depth <= 2 * 10 + 2;
+}
+
+bool testBounded() {
+    sjtu::priority_queue<int> q(10);
+    for (int i = 0; i < 1000; i++) q.push(i);
+    sjtu::priority_queue<int>::statistics s = q.stats();
+    return s.allocations == 1 && s.bytes_allocated == 10 * sizeof(int) && s.merge_steps == 0;
+}
+
+int main() {
+    std::cout << (testMergeDepth() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testBounded() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
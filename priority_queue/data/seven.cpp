@@ -0,0 +1,77 @@
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "priority_queue.hpp"
+
+unsigned seed = 20240501;
+
+int rand() {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 1);
+}
+
+bool testTopK() {
+    const int K = 1000, N = 1000000;
+    sjtu::priority_queue<int> pq(K);
+    std::vector<int> all;
+    int accepted = 0;
+    for (int i = 0; i < N; i++) {
+        int x = rand();
+        all.push_back(x);
+        if (pq.push(x)) accepted++;
+    }
+    if (pq.size() != K || pq.capacity() != K || accepted >= N) return false;
+    std::sort(all.begin(), all.end(), std::greater<int>());
+    if (pq.worst() != all[K - 1] || pq.top() != all[0]) return false;
+    std::vector<int> res;
+    pq.drain_sorted(std::back_inserter(res));
+    if (!pq.empty()) return false;
+    return std::equal(res.begin(), res.end(), all.begin()) && res.size() == K;
+}
+
+bool testBoundedOperations() {
+    sjtu::priority_queue<int, std::greater<int>> pq(5);
+    for (int i = 10; i > 0; i--) pq.push(i);
+    if (pq.worst() != 5 || pq.top() != 1) return false;
+    pq.pop_worst();
+    if (pq.worst() != 4 || pq.size() != 4) return false;
+    sjtu::priority_queue<int, std::greater<int>> cp(pq), other;
+    other.push(0);
+    other.push(100);
+    cp.merge(other);
+    if (!other.empty() || cp.size() != 5 || cp.worst() != 4) return false;
+    pq = cp;
+    std::vector<int> res;
+    pq.drain_sorted(std::back_inserter(res));
+    int ans[] = {0, 1, 2, 3, 4};
+    if (!std::equal(res.begin(), res.end(), ans) || res.size() != 5) return false;
+    // the loop that drains an unbounded queue gives the same order
+    res.clear();
+    while (!cp.empty()) {
+        res.push_back(cp.top());
+        cp.pop();
+    }
+    if (!std::equal(res.begin(), res.end(), ans) || res.size() != 5) return false;
+    try {
+        other.pop_worst();
+        return false;
+    } catch (const sjtu::runtime_error &) {}
+    try {
+        pq.pop();
+        return false;
+    } catch (const sjtu::container_is_empty &) {}
+    try {
+        sjtu::priority_queue<int> bad(0);
+        return false;
+    } catch (const sjtu::runtime_error &) {}
+    return true;
+}
+
+int main() {
+    std::cout << (testTopK() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testBoundedOperations() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <thread>
+
+#include "concurrent_priority_queue.hpp"
+
+const int THREADS = 8;
+const int PER_THREAD = 20000;
+
+int rand(unsigned &seed) {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 1);
+}
+
+bool testRelaxed() {
+    sjtu::concurrent_priority_queue<int> pq(16);
+    std::vector<std::thread> workers;
+    std::vector<int> pushed[THREADS], popped[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        workers.emplace_back([&, t]() {
+            unsigned seed = t + 1;
+            for (int i = 0; i < PER_THREAD; i++) {
+                int x = rand(seed);
+                pq.push(x);
+                pushed[t].push_back(x);
+                if (i % 3 == 0) {
+                    int y;
+                    if (pq.try_pop(y)) popped[t].push_back(y);
+                }
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    std::vector<int> in, out;
+    for (int t = 0; t < THREADS; t++) {
+        in.insert(in.end(), pushed[t].begin(), pushed[t].end());
+        out.insert(out.end(), popped[t].begin(), popped[t].end());
+    }
+    if (pq.size() + out.size() != in.size()) return false;
+    while (!pq.empty()) out.push_back(pq.pop());
+    std::sort(in.begin(), in.end());
+    std::sort(out.begin(), out.end());
+    return in == out;
+}
+
+bool testStrict() {
+    sjtu::concurrent_priority_queue<int> pq(8, true);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; t++) {
+        workers.emplace_back([&, t]() {
+            unsigned seed = t + 100;
+            for (int i = 0; i < PER_THREAD; i++) pq.push(rand(seed));
+        });
+    }
+    for (auto &w : workers) w.join();
+    if (pq.size() != THREADS * PER_THREAD) return false;
+    int last = pq.pop();
+    while (!pq.empty()) {
+        int x = pq.pop();
+        if (last < x) return false;
+        last = x;
+    }
+    try {
+        pq.pop();
+    } catch (const sjtu::container_is_empty &) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    std::cout << (testRelaxed() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testStrict() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
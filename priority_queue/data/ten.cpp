@@ -0,0 +1,61 @@
+#include <iostream>
+#include <type_traits>
+#include <vector>
+#include "priority_queue.hpp"
+
+static_assert(std::is_nothrow_move_constructible<sjtu::priority_queue<int>>::value, "move may not throw");
+static_assert(std::is_nothrow_move_assignable<sjtu::priority_queue<int>>::value, "move may not throw");
+
+template<class Queue>
+std::vector<int> drain(Queue &q) {
+    std::vector<int> out;
+    while (!q.empty()) {
+        out.push_back(q.top());
+        q.pop();
+    }
+    return out;
+}
+
+bool testMove() {
+    sjtu::priority_queue<int> a;
+    for (int i = 0; i < 100; i++) a.push(i * 37 % 100);
+    sjtu::priority_queue<int> b(std::move(a));
+    if (!a.empty() || b.size() != 100 || b.top() != 99) return false;
+    a.push(5);
+    a = std::move(b);
+    if (!b.empty() || a.size() != 100) return false;
+    b.push(1);
+    b.push(3);
+    std::vector<int> got = drain(a);
+    for (int i = 0; i < 100; i++) if (got[i] != 99 - i) return false;
+    return b.top() == 3;
+}
+
+bool testBoundedMove() {
+    sjtu::priority_queue<int> a(3);
+    for (int i = 0; i < 10; i++) a.push(i);
+    sjtu::priority_queue<int> b(std::move(a));
+    // a is an ordinary unbounded queue afterwards
+    if (b.capacity() != 3 || a.capacity() != 0 || !a.empty()) return false;
+    for (int i = 0; i < 10; i++) a.push(i);
+    std::vector<int> top(3);
+    b.drain_sorted(top.begin());
+    return top[0] == 9 && top[2] == 7 && a.size() == 10;
+}
+
+bool testSwap() {
+    sjtu::priority_queue<int> a(2), b;
+    a.push(4), a.push(8), a.push(6);
+    b.push(1);
+    swap(a, b);
+    if (a.capacity() != 0 || a.top() != 1 || b.capacity() != 2 || b.top() != 8) return false;
+    a.swap(b);
+    return a.size() == 2 && b.size() == 1 && a.top() == 8 && a.worst() == 6;
+}
+
+int main() {
+    std::cout << (testMove() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testBoundedMove() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testSwap() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
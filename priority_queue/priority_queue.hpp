@@ -3,15 +3,39 @@
 
 #include <cstddef>
 #include <functional>
+#include <memory>
+#include <utility>
 #include "exceptions.hpp"
 
 namespace sjtu {
 
 /**
  * a container like std::priority_queue which is a heap internal.
+ *
+ * constructed with a capacity k it works in bounded (top-k) mode instead:
+ * only the k best elements pushed so far are kept in a flat array heap
+ * ordered worst-first, so a push that can not beat the worst one is
+ * rejected with one comparison and no allocation.
+ * top() and pop() still mean the best element, but cost O(k) there:
+ * use drain_sorted() to get the result best-first, and worst() and
+ * pop_worst() for the element the next push has to beat.
  */
     template<typename T, class Compare = std::less<T>>
     class priority_queue {
+    public:
+        /**
+         * counters kept when compiled with SJTU_STATS defined, all zero otherwise.
+         * SJTU_STATS changes the class layout: define it in every translation unit or in none.
+         * merge_steps counts the recursive steps of the leftist merges, which walk the
+         * right spines; max_merge_depth is the longest such walk seen.
+         */
+        struct statistics {
+            size_t allocations = 0;
+            size_t bytes_allocated = 0;
+            size_t merge_steps = 0;
+            size_t max_merge_depth = 0;
+        };
+
     private:
         struct pq_node {
             pq_node *l_son = nullptr, *r_son = nullptr;
@@ -23,10 +47,44 @@ namespace sjtu {
 
         pq_node *root;
         size_t _size;
+        std::allocator<T> alloc;
+        T *heap;
+        size_t bound;
+#ifdef SJTU_STATS
+        statistics _stats;
+        size_t _merge_depth = 0;
+#endif
+
+        void note_allocation(size_t bytes) {
+#ifdef SJTU_STATS
+            _stats.allocations++;
+            _stats.bytes_allocated += bytes;
+#else
+            (void) bytes;
+#endif
+        }
+
+        pq_node *new_node(const T &e) {
+            note_allocation(sizeof(pq_node) + sizeof(T));
+            return new pq_node(e);
+        }
+
+        void enter_merge() {
+#ifdef SJTU_STATS
+            _stats.merge_steps++;
+            if (++_merge_depth > _stats.max_merge_depth) _stats.max_merge_depth = _merge_depth;
+#endif
+        }
+
+        void leave_merge() {
+#ifdef SJTU_STATS
+            _merge_depth--;
+#endif
+        }
 
         pq_node *copy(pq_node *other) {
             if (other == nullptr) return nullptr;
-            pq_node *p = new pq_node(*(other->data));
+            pq_node *p = new_node(*(other->data));
             p->l_son = copy(other->l_son);
             p->r_son = copy(other->r_son);
             return p;
@@ -47,7 +105,9 @@ namespace sjtu {
                 a = b;
                 b = tmp;
             }
+            enter_merge();
             a->r_son = merge(a->r_son, b);
+            leave_merge();
             if (a->l_son == nullptr || a->l_son->npl < a->r_son->npl) {
                 pq_node *tmp = a->l_son;
                 a->l_son = a->r_son;
@@ -58,15 +118,157 @@ namespace sjtu {
             return a;
         }
 
+        /**
+         * meld n heaps in rounds of adjacent pairs, O(n) in total.
+         */
+        pq_node *meld_all(pq_node **list, size_t n) {
+            if (n == 0) return nullptr;
+            while (n > 1) {
+                for (size_t i = 0; i < n / 2; i++) list[i] = merge(list[2 * i], list[2 * i + 1]);
+                if (n & 1) list[n / 2] = list[n - 1];
+                n = (n + 1) / 2;
+            }
+            return list[0];
+        }
+
+        /**
+         * bounded mode: heap[0] is the worst element,
+         * no child is worse than its parent.
+         */
+        void sift_up(size_t i) {
+            while (i > 0) {
+                size_t fa = (i - 1) >> 1;
+                if (!Compare()(heap[i], heap[fa])) break;
+                std::swap(heap[i], heap[fa]);
+                i = fa;
+            }
+        }
+
+        void sift_down(size_t i, size_t n) {
+            for (size_t son = 2 * i + 1; son < n; i = son, son = 2 * i + 1) {
+                if (son + 1 < n && Compare()(heap[son + 1], heap[son])) son++;
+                if (!Compare()(heap[son], heap[i])) break;
+                std::swap(heap[i], heap[son]);
+            }
+        }
+
+        /**
+         * bounded mode: the best element is one of the leaves.
+         */
+        size_t best_at() const {
+            size_t best = _size / 2;
+            for (size_t i = best + 1; i < _size; i++) {
+                if (Compare()(heap[best], heap[i])) best = i;
+            }
+            return best;
+        }
+
+        /**
+         * bounded mode: remove heap[i], filling its place with the last element.
+         */
+        void erase_at(size_t i) {
+            _size--;
+            if (i != _size) heap[i] = std::move(heap[_size]);
+            alloc.destroy(heap + _size);
+            if (i == _size) return;
+            sift_up(i);
+            sift_down(i, _size);
+        }
+
+        /**
+         * bounded mode, after a pop_while pass kept [0, kept) and visited [kept, i):
+         * move the unvisited elements down, drop the visited ones and rebuild the heap.
+         */
+        void close_gap(size_t kept, size_t i) {
+            for (; i < _size; i++) std::swap(heap[kept++], heap[i]);
+            for (size_t j = kept; j < _size; j++) alloc.destroy(heap + j);
+            _size = kept;
+            for (size_t j = _size / 2; j > 0; j--) sift_down(j - 1, _size);
+        }
+
+        void copy_bounded(const priority_queue &other) {
+            heap = alloc.allocate(bound);
+            note_allocation(bound * sizeof(T));
+            for (size_t i = 0; i < _size; i++) alloc.construct(heap + i, other.heap[i]);
+        }
+
+        void clear_bounded() {
+            for (size_t i = 0; i < _size; i++) alloc.destroy(heap + i);
+            alloc.deallocate(heap, bound);
+            heap = nullptr;
+        }
+
+        void push_tree(pq_node *p) {
+            if (p == nullptr) return;
+            push(*(p->data));
+            push_tree(p->l_son);
+            push_tree(p->r_son);
+        }
+
+        /**
+         * the subtrees of a pop_while traversal: the due ones still to visit and the
+         * ones left behind. however the traversal ends, all of them are melded back
+         * into root, so a throwing pred or output iterator leaves a valid heap.
+         */
+        struct cut {
+            priority_queue &q;
+            size_t cap = 16, top_n = 0, rest_n = 0;
+            pq_node **stack, **rest;
+
+            explicit cut(priority_queue &q) : q(q), stack(new pq_node *[32]), rest(stack + 16) {}
+
+            ~cut() {
+                pq_node *due = q.meld_all(stack, top_n), *left = q.meld_all(rest, rest_n);
+                q.root = q.merge(q.root, q.merge(due, left));
+                delete[] stack;
+            }
+
+            /**
+             * room for the two sons of a node in either list
+             */
+            void reserve() {
+                if (top_n + 2 <= cap && rest_n + 2 <= cap) return;
+                pq_node **buf = new pq_node *[cap * 4];
+                for (size_t i = 0; i < top_n; i++) buf[i] = stack[i];
+                for (size_t i = 0; i < rest_n; i++) buf[cap * 2 + i] = rest[i];
+                delete[] stack;
+                stack = buf, rest = buf + cap * 2, cap *= 2;
+            }
+        };
+
     public:
         /**
          * TODO constructors
          */
-        priority_queue() : root(nullptr), _size(0) {}
+        priority_queue() : root(nullptr), _size(0), heap(nullptr), bound(0) {}
+
+        /**
+         * bounded mode keeping at most capacity elements.
+         * throw runtime_error if capacity is 0.
+         */
+        explicit priority_queue(size_t capacity) : root(nullptr), _size(0), heap(nullptr), bound(capacity) {
+            if (capacity == 0) throw sjtu::runtime_error();
+            heap = alloc.allocate(bound);
+            note_allocation(bound * sizeof(T));
+        }
 
         priority_queue(const priority_queue &other) {
             _size = other._size;
+            bound = other.bound;
             root = copy(other.root);
+            heap = nullptr;
+            if (bound) copy_bounded(other);
+        }
+
+        /**
+         * take the heap of other, which is left an empty unbounded queue.
+         */
+        priority_queue(priority_queue &&other) noexcept
+                : root(other.root), _size(other._size), heap(other.heap), bound(other.bound) {
+            other.root = nullptr;
+            other._size = 0;
+            other.heap = nullptr;
+            other.bound = 0;
         }
 
         /**
@@ -74,6 +276,7 @@ namespace sjtu {
          */
         ~priority_queue() {
             clear(root);
+            if (bound) clear_bounded();
             root = nullptr;
             _size = 0;
         }
@@ -84,29 +287,71 @@ namespace sjtu {
         priority_queue &operator=(const priority_queue &other) {
             if (this == &other) return *this;
             clear(root);
+            if (bound) clear_bounded();
             _size = other._size;
+            bound = other.bound;
             root = copy(other.root);
+            if (bound) copy_bounded(other);
+            return *this;
+        }
+
+        priority_queue &operator=(priority_queue &&other) noexcept {
+            if (this == &other) return *this;
+            priority_queue tmp(std::move(other));
+            swap(tmp);
             return *this;
         }
 
+        void swap(priority_queue &other) noexcept {
+            std::swap(root, other.root);
+            std::swap(_size, other._size);
+            std::swap(heap, other.heap);
+            std::swap(bound, other.bound);
+        }
+
         /**
          * get the top of the queue.
-         * @return a reference of the top element.
+         * @return a reference of the top element, found in O(k) in bounded mode.
          * throw container_is_empty if empty() returns true;
          */
         const T &top() const {
             if (empty()) throw sjtu::container_is_empty();
+            if (bound) return heap[best_at()];
             return *(root->data);
         }
 
+        /**
+         * the worst kept element of a bounded queue, which a push has to beat.
+         * throw runtime_error if the queue is not bounded,
+         * container_is_empty if empty() returns true.
+         */
+        const T &worst() const {
+            if (!bound) throw sjtu::runtime_error();
+            if (empty()) throw sjtu::container_is_empty();
+            return heap[0];
+        }
+
         /**
          * TODO
          * push new element to the priority queue.
+         * return false if it is rejected by a full bounded queue.
          */
-        void push(const T &e) {
-            pq_node *p = new pq_node(e);
+        bool push(const T &e) {
+            if (bound) {
+                if (_size == bound) {
+                    if (!Compare()(heap[0], e)) return false;
+                    heap[0] = e;
+                    sift_down(0, _size);
+                    return true;
+                }
+                alloc.construct(heap + _size, e);
+                sift_up(_size++);
+                return true;
+            }
+            pq_node *p = new_node(e);
             root = merge(root, p);
             _size++;
+            return true;
         }
 
         /**
@@ -116,12 +361,107 @@ namespace sjtu {
          */
         void pop() {
             if (empty()) throw sjtu::container_is_empty();
+            if (bound) {
+                erase_at(best_at());
+                return;
+            }
             pq_node *p = root;
             root = merge(root->l_son, root->r_son);
             delete p;
             _size--;
         }
 
+        /**
+         * delete the worst kept element of a bounded queue.
+         * throw runtime_error if the queue is not bounded,
+         * container_is_empty if empty() returns true.
+         */
+        void pop_worst() {
+            if (!bound) throw sjtu::runtime_error();
+            if (empty()) throw sjtu::container_is_empty();
+            erase_at(0);
+        }
+
+        /**
+         * push all the elements in [first, last) (forward iterators).
+         * the batch is built into a heap in O(k) and then melded once.
+         */
+        template<class ForwardIt>
+        void push_bulk(ForwardIt first, ForwardIt last) {
+            if (bound) {
+                for (; first != last; ++first) push(*first);
+                return;
+            }
+            size_t k = 0;
+            for (ForwardIt it = first; it != last; ++it) k++;
+            if (k == 0) return;
+            pq_node **list = new pq_node *[k];
+            size_t n = 0;
+            try {
+                for (; first != last; ++first) list[n++] = new_node(*first);
+            } catch (...) {
+                for (size_t i = 0; i < n; i++) delete list[i];
+                delete[] list;
+                throw;
+            }
+            root = merge(root, meld_all(list, n));
+            _size += n;
+            delete[] list;
+        }
+
+        /**
+         * pop every element e with pred(e) true and write it to out.
+         * pred must be monotone: if it holds for an element, it holds for every better one,
+         * e.g. "deadline <= now" for timers. Then the due elements form a top part of the
+         * heap, which is cut off in one traversal and the remaining subtrees melded once.
+         * the elements are written in traversal order, not sorted. if pred or the output
+         * throws, the elements not written yet stay in the queue.
+         * a bounded queue is scanned once and its heap rebuilt, in O(k).
+         */
+        template<class Pred, class OutputIt>
+        OutputIt pop_while(Pred pred, OutputIt out) {
+            if (bound) {
+                size_t kept = 0, i = 0;
+                try {
+                    for (; i < _size; i++) {
+                        if (!pred(heap[i])) {
+                            std::swap(heap[kept++], heap[i]);
+                            continue;
+                        }
+                        *out = heap[i];
+                        ++out;
+                    }
+                } catch (...) {
+                    close_gap(kept, i);
+                    throw;
+                }
+                close_gap(kept, i);
+                return out;
+            }
+            if (root == nullptr || !pred(*(root->data))) return out;
+            cut c(*this);
+            c.stack[c.top_n++] = root;
+            root = nullptr;
+            while (c.top_n > 0) {
+                // a node leaves the stack only once nothing about it can throw any more
+                pq_node *p = c.stack[c.top_n - 1];
+                pq_node *son[2] = {p->l_son, p->r_son};
+                c.reserve();
+                bool due[2] = {son[0] != nullptr && pred(*(son[0]->data)), son[1] != nullptr && pred(*(son[1]->data))};
+                *out = *(p->data);
+                c.top_n--;
+                delete p;
+                _size--;
+                for (int i = 0; i < 2; i++) {
+                    if (son[i] == nullptr) continue;
+                    if (due[i]) c.stack[c.top_n++] = son[i];
+                    else c.rest[c.rest_n++] = son[i];
+                }
+                ++out;
+            }
+            return out;
+        }
+
         /**
          * return the number of the elements.
          */
@@ -133,18 +473,83 @@ namespace sjtu {
          */
         bool empty() const { return _size == 0; }
 
+        /**
+         * return the capacity of a bounded queue, 0 if it is not bounded.
+         */
+        size_t capacity() const { return bound; }
+
+        /**
+         * write all the elements to out from the best to the worst and clear the queue.
+         * O(klogk) in place for a bounded queue.
+         */
+        template<class OutputIt>
+        OutputIt drain_sorted(OutputIt out) {
+            if (bound) {
+                for (size_t n = _size; n > 1; n--) {
+                    std::swap(heap[0], heap[n - 1]);
+                    sift_down(0, n - 1);
+                }
+                for (size_t i = 0; i < _size; i++) {
+                    *out = heap[i];
+                    ++out;
+                    alloc.destroy(heap + i);
+                }
+                _size = 0;
+                return out;
+            }
+            while (!empty()) {
+                *out = top();
+                ++out;
+                pop();
+            }
+            return out;
+        }
+
         /**
          * merge two priority_queues with at least O(logn) complexity.
          * clear the other priority_queue.
+         * if either queue is bounded, the elements of other are pushed one by one.
          */
         void merge(priority_queue &other) {
+            if (this == &other) return;
+            if (bound || other.bound) {
+                if (other.bound) {
+                    for (size_t i = 0; i < other._size; i++) push(other.heap[i]);
+                    for (size_t i = 0; i < other._size; i++) other.alloc.destroy(other.heap + i);
+                } else {
+                    push_tree(other.root);
+                    clear(other.root);
+                    other.root = nullptr;
+                }
+                other._size = 0;
+                return;
+            }
             root = merge(root, other.root);
             _size += other._size;
             other.root = nullptr;
             other._size = 0;
         }
+
+        statistics stats() const {
+#ifdef SJTU_STATS
+            return _stats;
+#else
+            return statistics();
+#endif
+        }
+
+        void reset_stats() {
+#ifdef SJTU_STATS
+            _stats = statistics();
+#endif
+        }
     };
 
+    template<typename T, class Compare>
+    void swap(priority_queue<T, Compare> &a, priority_queue<T, Compare> &b) noexcept {
+        a.swap(b);
+    }
+
 }
 
 #endif
\ No newline at end of file
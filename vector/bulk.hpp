@@ -0,0 +1,302 @@
+#ifndef SJTU_BULK_HPP
+#define SJTU_BULK_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SJTU_BULK_DISPATCH 1
+#define SJTU_BULK_INLINE inline __attribute__((always_inline))
+#else
+#define SJTU_BULK_DISPATCH 0
+#define SJTU_BULK_INLINE inline
+#endif
+
+namespace sjtu {
+    /**
+     * whole-array kernels for vectors (or plain arrays) of numbers: find, count,
+     * min, max, sum and fill.
+     * the loops are written so the compiler vectorizes them, and on x86 each one is
+     * built for AVX-512, AVX2 and the baseline, picking the widest the cpu runs
+     * (checked once); elsewhere only the baseline is built.
+     * results with NaNs in the input are unspecified.
+     */
+    namespace bulk {
+        enum isa {
+            scalar,
+            avx2,
+            avx512
+        };
+
+        /**
+         * the sum of T is accumulated in this type.
+         */
+        template<typename T>
+        using sum_type = typename std::conditional<std::is_floating_point<T>::value, double,
+                typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type>::type;
+    }
+
+    namespace detail {
+        namespace bulk {
+            template<typename T>
+            struct kernels {
+                static const size_t lanes = 64 / sizeof(T);  // one cache line of T
+                typedef typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type counter;
+
+                static SJTU_BULK_INLINE size_t find(const T *p, size_t n, T value) {
+                    size_t i = 0;
+                    // look at whole blocks without branching, then find the match in the hit block
+                    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+                        counter hit = 0;
+                        for (size_t k = 0; k < 4 * lanes; k++) hit |= p[i + k] == value ? 1 : 0;
+                        if (hit) break;
+                    }
+                    for (; i < n; i++) {
+                        if (p[i] == value) return i;
+                    }
+                    return n;
+                }
+
+                static SJTU_BULK_INLINE size_t count(const T *p, size_t n, T value) {
+                    // one counter as wide as T per lane, flushed before it can wrap
+                    const size_t chunk = (size_t) 1 << 30;
+                    counter c[lanes];
+                    size_t total = 0, i = 0;
+                    while (i + lanes <= n) {
+                        for (size_t k = 0; k < lanes; k++) c[k] = 0;
+                        size_t end = n - i < chunk ? n : i + chunk;
+                        for (; i + lanes <= end; i += lanes) {
+                            for (size_t k = 0; k < lanes; k++) c[k] += p[i + k] == value ? 1 : 0;
+                        }
+                        for (size_t k = 0; k < lanes; k++) total += c[k];
+                    }
+                    for (; i < n; i++) total += p[i] == value;
+                    return total;
+                }
+
+                static SJTU_BULK_INLINE T min(const T *p, size_t n) {
+                    T m[lanes];
+                    for (size_t k = 0; k < lanes; k++) m[k] = p[0];
+                    size_t i = 0;
+                    for (; i + lanes <= n; i += lanes) {
+                        for (size_t k = 0; k < lanes; k++) m[k] = p[i + k] < m[k] ? p[i + k] : m[k];
+                    }
+                    for (; i < n; i++) m[0] = p[i] < m[0] ? p[i] : m[0];
+                    T best = m[0];
+                    for (size_t k = 1; k < lanes; k++) best = m[k] < best ? m[k] : best;
+                    return best;
+                }
+
+                static SJTU_BULK_INLINE T max(const T *p, size_t n) {
+                    T m[lanes];
+                    for (size_t k = 0; k < lanes; k++) m[k] = p[0];
+                    size_t i = 0;
+                    for (; i + lanes <= n; i += lanes) {
+                        for (size_t k = 0; k < lanes; k++) m[k] = m[k] < p[i + k] ? p[i + k] : m[k];
+                    }
+                    for (; i < n; i++) m[0] = m[0] < p[i] ? p[i] : m[0];
+                    T best = m[0];
+                    for (size_t k = 1; k < lanes; k++) best = best < m[k] ? m[k] : best;
+                    return best;
+                }
+
+                static SJTU_BULK_INLINE sjtu::bulk::sum_type<T> sum(const T *p, size_t n) {
+                    typedef sjtu::bulk::sum_type<T> S;
+                    // independent partial sums, so floating point adds need no reassociation
+                    S acc[lanes];
+                    for (size_t k = 0; k < lanes; k++) acc[k] = 0;
+                    size_t i = 0;
+                    for (; i + lanes <= n; i += lanes) {
+                        for (size_t k = 0; k < lanes; k++) acc[k] += p[i + k];
+                    }
+                    for (; i < n; i++) acc[0] += p[i];
+                    S total = 0;
+                    for (size_t k = 0; k < lanes; k++) total += acc[k];
+                    return total;
+                }
+
+                static SJTU_BULK_INLINE void fill(T *p, size_t n, T value) {
+                    for (size_t i = 0; i < n; i++) p[i] = value;
+                }
+            };
+
+            /**
+             * one function per kernel and instruction set; the kernels are inlined into
+             * these, so each copy is compiled for its target.
+             */
+#define SJTU_BULK_KERNELS(prefix, attributes)                                                            \
+            template<typename T>                                                                         \
+            attributes size_t prefix##_find(const T *p, size_t n, T v) { return kernels<T>::find(p, n, v); } \
+            template<typename T>                                                                         \
+            attributes size_t prefix##_count(const T *p, size_t n, T v) { return kernels<T>::count(p, n, v); } \
+            template<typename T>                                                                         \
+            attributes T prefix##_min(const T *p, size_t n) { return kernels<T>::min(p, n); }              \
+            template<typename T>                                                                         \
+            attributes T prefix##_max(const T *p, size_t n) { return kernels<T>::max(p, n); }              \
+            template<typename T>                                                                         \
+            attributes sjtu::bulk::sum_type<T> prefix##_sum(const T *p, size_t n) { return kernels<T>::sum(p, n); } \
+            template<typename T>                                                                         \
+            attributes void prefix##_fill(T *p, size_t n, T v) { kernels<T>::fill(p, n, v); }
+
+            SJTU_BULK_KERNELS(scalar, )
+#if SJTU_BULK_DISPATCH
+            SJTU_BULK_KERNELS(avx2, __attribute__((target("avx2"))))
+            SJTU_BULK_KERNELS(avx512, __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl"))))
+#endif
+#undef SJTU_BULK_KERNELS
+
+            inline sjtu::bulk::isa supported() {
+#if SJTU_BULK_DISPATCH
+                static const sjtu::bulk::isa best = []() {
+                    __builtin_cpu_init();
+                    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+                        return sjtu::bulk::avx512;
+                    if (__builtin_cpu_supports("avx2")) return sjtu::bulk::avx2;
+                    return sjtu::bulk::scalar;
+                }();
+                return best;
+#else
+                return sjtu::bulk::scalar;
+#endif
+            }
+
+            inline sjtu::bulk::isa &selected() {
+                static sjtu::bulk::isa level = supported();
+                return level;
+            }
+
+            template<typename T>
+            void check_arithmetic() {
+                static_assert(std::is_arithmetic<T>::value, "the bulk kernels work on numbers");
+            }
+        }
+    }
+
+    namespace bulk {
+        /**
+         * the widest instruction set this cpu can run the kernels with.
+         */
+        inline isa supported() {
+            return detail::bulk::supported();
+        }
+
+        /**
+         * the instruction set the kernels use, supported() unless lowered by use().
+         */
+        inline isa selected() {
+            return detail::bulk::selected();
+        }
+
+        /**
+         * run the kernels with level, or with supported() if the cpu lacks it.
+         * for tests and measurements, not thread safe against running kernels.
+         */
+        inline void use(isa level) {
+            detail::bulk::selected() = level > supported() ? supported() : level;
+        }
+
+#if SJTU_BULK_DISPATCH
+#define SJTU_BULK_DISPATCH_TO(kernel, ...)                                              \
+        switch (selected()) {                                                         \
+            case avx512: return detail::bulk::avx512_##kernel(__VA_ARGS__);           \
+            case avx2: return detail::bulk::avx2_##kernel(__VA_ARGS__);               \
+            default: return detail::bulk::scalar_##kernel(__VA_ARGS__);               \
+        }
+#else
+#define SJTU_BULK_DISPATCH_TO(kernel, ...) return detail::bulk::scalar_##kernel(__VA_ARGS__);
+#endif
+
+        /**
+         * the position of the first element equal to value, n if there is none.
+         */
+        template<typename T>
+        size_t find(const T *p, size_t n, const T &value) {
+            detail::bulk::check_arithmetic<T>();
+            SJTU_BULK_DISPATCH_TO(find, p, n, value)
+        }
+
+        template<typename T>
+        size_t count(const T *p, size_t n, const T &value) {
+            detail::bulk::check_arithmetic<T>();
+            SJTU_BULK_DISPATCH_TO(count, p, n, value)
+        }
+
+        /**
+         * throws container_is_empty when n is 0.
+         */
+        template<typename T>
+        T min(const T *p, size_t n) {
+            detail::bulk::check_arithmetic<T>();
+            if (n == 0) throw sjtu::container_is_empty();
+            SJTU_BULK_DISPATCH_TO(min, p, n)
+        }
+
+        /**
+         * throws container_is_empty when n is 0.
+         */
+        template<typename T>
+        T max(const T *p, size_t n) {
+            detail::bulk::check_arithmetic<T>();
+            if (n == 0) throw sjtu::container_is_empty();
+            SJTU_BULK_DISPATCH_TO(max, p, n)
+        }
+
+        /**
+         * the sum in sum_type<T>: long long, unsigned long long or double.
+         * floating point sums are added in a different order than a plain loop would.
+         */
+        template<typename T>
+        sum_type<T> sum(const T *p, size_t n) {
+            detail::bulk::check_arithmetic<T>();
+            SJTU_BULK_DISPATCH_TO(sum, p, n)
+        }
+
+        template<typename T>
+        void fill(T *p, size_t n, const T &value) {
+            detail::bulk::check_arithmetic<T>();
+            SJTU_BULK_DISPATCH_TO(fill, p, n, value)
+        }
+
+#undef SJTU_BULK_DISPATCH_TO
+
+        template<typename T>
+        size_t find(const vector<T> &v, const T &value) {
+            return find(v.data(), v.size(), value);
+        }
+
+        template<typename T>
+        size_t count(const vector<T> &v, const T &value) {
+            return count(v.data(), v.size(), value);
+        }
+
+        template<typename T>
+        T min(const vector<T> &v) {
+            return min(v.data(), v.size());
+        }
+
+        template<typename T>
+        T max(const vector<T> &v) {
+            return max(v.data(), v.size());
+        }
+
+        template<typename T>
+        sum_type<T> sum(const vector<T> &v) {
+            return sum(v.data(), v.size());
+        }
+
+        template<typename T>
+        void fill(vector<T> &v, const T &value) {
+            fill(v.data(), v.size(), value);
+        }
+    }
+}
+
+#undef SJTU_BULK_INLINE
+#undef SJTU_BULK_DISPATCH
+
+#endif
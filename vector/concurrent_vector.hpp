@@ -0,0 +1,238 @@
+#ifndef SJTU_CONCURRENT_VECTOR_HPP
+#define SJTU_CONCURRENT_VECTOR_HPP
+
+#include "exceptions.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+    /**
+     * an append-only vector that many threads can push to at once without a lock.
+     * a push takes the next index from an atomic counter and constructs the element
+     * in place; storage is a fixed table of segments of 32, 64, 128, ... slots, so
+     * elements never move and a missing segment is installed with one compare-and-swap.
+     * an element is published once constructed: at() / operator[] on a published
+     * index is wait-free, an index that is not published yet (or whose constructor
+     * threw) reads as out of bound.
+     * clear() and destruction must not run concurrently with anything else.
+     */
+    template<typename T>
+    class concurrent_vector {
+    private:
+        static const int first_shift = 5;
+        static const int segment_count = (int) (sizeof(size_t) * CHAR_BIT) - first_shift;
+        static const size_t segment_alignment = alignof(T) > 64 ? alignof(T) : 64;
+
+        typedef std::atomic<unsigned char> flag;
+
+        /**
+         * slots handed out, the elements may still be under construction
+         */
+        alignas(64) std::atomic<size_t> _size;
+        /**
+         * segment k is a block of segment_size(k) ready flags followed by as many slots
+         */
+        std::atomic<unsigned char *> _segments[segment_count];
+
+        static size_t segment_size(int k) {
+            return (size_t) 1 << (first_shift + k);
+        }
+
+        static size_t flag_bytes(int k) {
+            return (segment_size(k) * sizeof(flag) + segment_alignment - 1) / segment_alignment * segment_alignment;
+        }
+
+        static void locate(size_t i, int &k, size_t &offset) {
+            size_t t = i + segment_size(0);
+            int top = (int) (sizeof(unsigned long long) * CHAR_BIT) - 1 - __builtin_clzll(t);
+            k = top - first_shift;
+            offset = t - ((size_t) 1 << top);
+        }
+
+        static flag *flags(unsigned char *s) {
+            return reinterpret_cast<flag *>(s);
+        }
+
+        static T *slots(unsigned char *s, int k) {
+            return reinterpret_cast<T *>(s + flag_bytes(k));
+        }
+
+        /**
+         * segment k, installed by whichever thread gets there first.
+         */
+        unsigned char *segment(int k) {
+            unsigned char *s = _segments[k].load(std::memory_order_acquire);
+            if (s != nullptr) return s;
+            unsigned char *fresh = static_cast<unsigned char *>(::operator new(
+                    flag_bytes(k) + segment_size(k) * sizeof(T), std::align_val_t(segment_alignment)));
+            for (size_t i = 0; i < segment_size(k); i++) new(flags(fresh) + i) flag(0);
+            if (_segments[k].compare_exchange_strong(s, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return fresh;
+            }
+            ::operator delete(fresh, std::align_val_t(segment_alignment));
+            return s;
+        }
+
+        /**
+         * the slot for index i; the thread halfway through a segment installs the
+         * next one, so pushers rarely race to allocate it.
+         */
+        T *claim(size_t i, flag *&ready) {
+            int k;
+            size_t offset;
+            locate(i, k, offset);
+            unsigned char *s = segment(k);
+            if (offset == segment_size(k) / 2 && k + 1 < segment_count) segment(k + 1);
+            ready = flags(s) + offset;
+            return slots(s, k) + offset;
+        }
+
+        /**
+         * the element at i if it is published, nullptr otherwise.
+         */
+        T *published_slot(size_t i) const {
+            if (i >= _size.load(std::memory_order_acquire)) return nullptr;
+            int k;
+            size_t offset;
+            locate(i, k, offset);
+            unsigned char *s = _segments[k].load(std::memory_order_acquire);
+            if (s == nullptr || flags(s)[offset].load(std::memory_order_acquire) == 0) return nullptr;
+            return slots(s, k) + offset;
+        }
+
+        template<class... Args>
+        void construct_at(size_t i, Args &&... args) {
+            flag *ready;
+            T *p = claim(i, ready);
+            new(p) T(std::forward<Args>(args)...);
+            ready->store(1, std::memory_order_release);
+        }
+
+        void destroy_all() {
+            for (int k = 0; k < segment_count; k++) {
+                unsigned char *s = _segments[k].load(std::memory_order_relaxed);
+                if (s == nullptr) continue;
+                for (size_t offset = 0; offset < segment_size(k); offset++) {
+                    if (flags(s)[offset].load(std::memory_order_relaxed) == 0) continue;
+                    slots(s, k)[offset].~T();
+                    flags(s)[offset].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+
+    public:
+        concurrent_vector() : _size(0) {
+            for (int k = 0; k < segment_count; k++) _segments[k].store(nullptr, std::memory_order_relaxed);
+        }
+
+        concurrent_vector(const concurrent_vector &) = delete;
+
+        concurrent_vector &operator=(const concurrent_vector &) = delete;
+
+        ~concurrent_vector() {
+            destroy_all();
+            for (int k = 0; k < segment_count; k++) {
+                unsigned char *s = _segments[k].load(std::memory_order_relaxed);
+                if (s != nullptr) ::operator delete(s, std::align_val_t(segment_alignment));
+            }
+        }
+
+        /**
+         * append value and return its index.
+         */
+        size_t push_back(const T &value) {
+            size_t i = _size.fetch_add(1, std::memory_order_acq_rel);
+            construct_at(i, value);
+            return i;
+        }
+
+        size_t push_back(T &&value) {
+            size_t i = _size.fetch_add(1, std::memory_order_acq_rel);
+            construct_at(i, std::move(value));
+            return i;
+        }
+
+        template<class... Args>
+        size_t emplace_back(Args &&... args) {
+            size_t i = _size.fetch_add(1, std::memory_order_acq_rel);
+            construct_at(i, std::forward<Args>(args)...);
+            return i;
+        }
+
+        /**
+         * append n default constructed elements with one atomic add,
+         * return the index of the first.
+         */
+        size_t grow_by(size_t n) {
+            size_t first = _size.fetch_add(n, std::memory_order_acq_rel);
+            for (size_t i = first; i < first + n; i++) construct_at(i);
+            return first;
+        }
+
+        size_t grow_by(size_t n, const T &value) {
+            size_t first = _size.fetch_add(n, std::memory_order_acq_rel);
+            for (size_t i = first; i < first + n; i++) construct_at(i, value);
+            return first;
+        }
+
+        /**
+         * install the segments for the first n elements ahead of time.
+         */
+        void reserve(size_t n) {
+            if (n == 0) return;
+            int k;
+            size_t offset;
+            locate(n - 1, k, offset);
+            for (int j = 0; j <= k; j++) segment(j);
+        }
+
+        bool published(size_t pos) const {
+            return published_slot(pos) != nullptr;
+        }
+
+        T &at(const size_t &pos) {
+            T *p = published_slot(pos);
+            if (p == nullptr) throw sjtu::index_out_of_bound();
+            return *p;
+        }
+
+        const T &at(const size_t &pos) const {
+            const T *p = published_slot(pos);
+            if (p == nullptr) throw sjtu::index_out_of_bound();
+            return *p;
+        }
+
+        T &operator[](const size_t &pos) {
+            return at(pos);
+        }
+
+        const T &operator[](const size_t &pos) const {
+            return at(pos);
+        }
+
+        /**
+         * the number of indices handed out, the last few may not be published yet.
+         */
+        size_t size() const {
+            return _size.load(std::memory_order_acquire);
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /**
+         * destroy every element but keep the segments; not thread safe.
+         */
+        void clear() {
+            destroy_all();
+            _size.store(0, std::memory_order_release);
+        }
+    };
+}
+
+#endif
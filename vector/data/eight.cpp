@@ -0,0 +1,116 @@
+#include "mmap_vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <sys/stat.h>
+
+struct point {
+    int x, y;
+};
+
+typedef sjtu::mmap_vector<point>::iterator point_iterator;
+static_assert(std::is_same<std::iterator_traits<point_iterator>::difference_type, std::ptrdiff_t>::value &&
+              std::is_same<decltype(point_iterator() - point_iterator()), std::ptrdiff_t>::value,
+              "a file may hold more than INT_MAX elements");
+
+const char *path = "points.bin";
+
+long file_size() {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long) st.st_size : -1;
+}
+
+bool testCreate() {
+    sjtu::mmap_vector<point> v(path, sjtu::mmap_vector<point>::truncate);
+    if (!v.empty() || !v.writable()) return false;
+    for (int i = 0; i < 10000; i++) v.push_back(point{i, -i});
+    v.insert(0, point{-1, 1});
+    v.erase(v.begin() + 1);
+    v.insert(v.end(), v[0]);
+    v.pop_back();
+    std::reverse(v.begin() + 2, v.end());
+    std::reverse(v.begin() + 2, v.end());
+    sjtu::mmap_vector<point>::const_iterator last = v.end() - 1;
+    if (v.end() - v.begin() != 10000 || last - v.cbegin() != 9999 || v.begin() + 9999 != last) return false;
+    return v.size() == 10000 && v[0].x == -1 && v[1].x == 1 && v.back().x == 9999;
+}
+
+bool testReadOnly() {
+    if (file_size() != 10000 * (long) sizeof(point)) return false;
+    sjtu::mmap_vector<point> v(path, sjtu::mmap_vector<point>::read_only);
+    const sjtu::mmap_vector<point> &c = v;
+    v.advise(sjtu::mmap_vector<point>::sequential);
+    long sum = 0;
+    for (sjtu::mmap_vector<point>::const_iterator it = c.cbegin(); it != c.cend(); ++it) sum += (*it).x + (*it).y;
+    if (v.size() != 10000 || sum != 0 || c[1].x != 1 || c.data()[2].y != -2) return false;
+    // reading through the non-const api works, and a write stays out of the file
+    for (point &p : v) sum += p.x;
+    for (const point &p : c) sum -= p.x;
+    v[0].x = 5;
+    if (sum != 0 || c[0].x != 5 || v.data()[1].x != 1) return false;
+    int caught = 0;
+    try { v.push_back(point{0, 0}); } catch (const sjtu::runtime_error &) { caught++; }
+    try { v.resize(1); } catch (const sjtu::runtime_error &) { caught++; }
+    try { c.at(10000); } catch (const sjtu::index_out_of_bound &) { caught++; }
+    const sjtu::mmap_vector<point> again(path, sjtu::mmap_vector<point>::read_only);
+    return caught == 3 && v.size() == 10000 && again[0].x == -1 && file_size() == 10000 * (long) sizeof(point);
+}
+
+bool testAppend() {
+    {
+        sjtu::mmap_vector<point> v(path);
+        if (v.size() != 10000) return false;
+        point more[3] = {{1, 2}, {3, 4}, {5, 6}};
+        v.append(more, 3);
+        v[0].x = 0;
+        const point *mapped = v.data();
+        v.sync();
+        if (v.data() != mapped || v.size() != 10003) return false;
+        v.resize(20000);
+        if (v[19999].x != 0 || v.capacity() < 20000) return false;
+        v.resize(10003);
+    }
+    if (file_size() != 10003 * (long) sizeof(point)) return false;
+    const sjtu::mmap_vector<point> v(path, sjtu::mmap_vector<point>::read_only);
+    return v.size() == 10003 && v[0].x == 0 && v[10002].y == 6 && v[9999].y == -9999;
+}
+
+bool testMove() {
+    sjtu::mmap_vector<point> a(path), b;
+    b = std::move(a);
+    if (a.is_open() || !b.is_open() || b.size() != 10003) return false;
+    sjtu::mmap_vector<point> c(std::move(b));
+    swap(b, c);
+    return b.size() == 10003 && c.size() == 0;
+}
+
+bool testErrors() {
+    try {
+        sjtu::mmap_vector<point> v("missing.bin", sjtu::mmap_vector<point>::read_only);
+        return false;
+    } catch (...) {}
+    {
+        // a length that is not a whole number of elements
+        sjtu::mmap_vector<char> bytes(path, sjtu::mmap_vector<char>::truncate);
+        bytes.push_back('x');
+    }
+    try {
+        sjtu::mmap_vector<point> v(path, sjtu::mmap_vector<point>::read_only);
+        return false;
+    } catch (...) {}
+    std::remove(path);
+    return true;
+}
+
+int main() {
+    std::cout << (testCreate() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testReadOnly() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testAppend() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testMove() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testErrors() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
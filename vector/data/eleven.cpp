@@ -0,0 +1,69 @@
+#include "bulk.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+std::mt19937 rng(2024);
+
+/**
+ * every kernel on every instruction set the cpu has, against plain loops,
+ * over lengths that leave every possible tail.
+ */
+template<typename T>
+bool testKernels() {
+    for (size_t n = 0; n < 300; n += (n < 70 ? 1 : 37)) {
+        sjtu::vector<T> v;
+        for (size_t i = 0; i < n; i++) v.push_back((T) (rng() % 50) - (T) 20);
+        if (n != 0 && reinterpret_cast<uintptr_t>(v.data()) % 64 != 0) return false;
+        T needle = n == 0 ? T(1) : v[rng() % n];
+        size_t first = n, same = 0;
+        T lo = n == 0 ? T() : v[0], hi = lo;
+        sjtu::bulk::sum_type<T> total = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (v[i] == needle && first == n) first = i;
+            same += v[i] == needle;
+            lo = v[i] < lo ? v[i] : lo;
+            hi = hi < v[i] ? v[i] : hi;
+            total += v[i];
+        }
+        for (int level = sjtu::bulk::scalar; level <= sjtu::bulk::supported(); level++) {
+            sjtu::bulk::use((sjtu::bulk::isa) level);
+            if (sjtu::bulk::find(v, needle) != first || sjtu::bulk::find(v, T(99)) != n) return false;
+            if (sjtu::bulk::count(v, needle) != same || sjtu::bulk::sum(v) != total) return false;
+            if (n != 0 && (sjtu::bulk::min(v) != lo || sjtu::bulk::max(v) != hi)) return false;
+            sjtu::vector<T> w(v);
+            sjtu::bulk::fill(w, T(7));
+            if (sjtu::bulk::count(w, T(7)) != n) return false;
+        }
+    }
+    sjtu::bulk::use(sjtu::bulk::avx512);
+    return sjtu::bulk::selected() == sjtu::bulk::supported();
+}
+
+bool testEmpty() {
+    sjtu::vector<double> v;
+    int caught = 0;
+    try { sjtu::bulk::min(v); } catch (const sjtu::container_is_empty &) { caught++; }
+    try { sjtu::bulk::max(v); } catch (const sjtu::container_is_empty &) { caught++; }
+    return caught == 2 && sjtu::bulk::sum(v) == 0 && sjtu::bulk::find(v, 1.0) == 0;
+}
+
+bool testRawArrays() {
+    long long a[1000];
+    sjtu::bulk::fill(a, 1000, 3LL);
+    a[777] = -5;
+    return sjtu::bulk::sum(a + 1, 999) == 998 * 3 - 5 && sjtu::bulk::find(a, 1000, -5LL) == 777 &&
+           sjtu::bulk::min(a, 1000) == -5 && sjtu::bulk::max(a, 777) == 3;
+}
+
+int main() {
+    std::cout << (testKernels<int>() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testKernels<unsigned>() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testKernels<long long>() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testKernels<float>() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testKernels<double>() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testEmpty() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testRawArrays() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "eytzinger_index.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+unsigned seed = 1000000007;
+
+int rand() {
+    seed = seed * 1103515245u + 12345u;
+    return (int) (seed >> 1);
+}
+
+bool testAgainstBinarySearch() {
+    for (int n : {0, 1, 2, 3, 7, 8, 100, 4095, 100000}) {
+        std::vector<int> keys(n);
+        for (int &x : keys) x = rand() % (2 * n + 1);
+        std::sort(keys.begin(), keys.end());
+        sjtu::vector<int> v;
+        for (int x : keys) v.push_back(x);
+        sjtu::eytzinger_index<int> index(v);
+        if (index.size() != (size_t) n) return false;
+        for (int q = -1; q <= 2 * n + 1; q++) {
+            size_t lo = std::lower_bound(keys.begin(), keys.end(), q) - keys.begin();
+            size_t hi = std::upper_bound(keys.begin(), keys.end(), q) - keys.begin();
+            if (index.lower_bound(q) != lo || index.upper_bound(q) != hi) return false;
+            if (index.contains(q) != (lo != hi)) return false;
+        }
+    }
+    return true;
+}
+
+bool testComparatorAndCopy() {
+    double a[] = {9.5, 7.25, 7.25, 3.0, -1.0};
+    sjtu::eytzinger_index<double, std::greater<double>> index(a, a + 5);
+    sjtu::eytzinger_index<double, std::greater<double>> copy(index), assigned(a, a + 1);
+    assigned = copy;
+    return assigned.lower_bound(7.25) == 1 && assigned.upper_bound(7.25) == 3 && assigned.lower_bound(100) == 0 &&
+           assigned.lower_bound(-5) == 5 && !assigned.contains(8.0) && copy.contains(3.0);
+}
+
+int main() {
+    std::cout << (testAgainstBinarySearch() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testComparatorAndCopy() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
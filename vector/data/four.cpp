@@ -1,6 +1,6 @@
 //provided by ivy
 
-#include "zfy.hpp"
+#include "vector.hpp"
 #include "class-matrix.hpp"
 #include "class-bint.hpp"
 #include <iostream>
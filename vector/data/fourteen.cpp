@@ -0,0 +1,152 @@
+#include "flat_map.hpp"
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+bool testAgainstMap() {
+    sjtu::flat_map<int, long long> f;
+    std::map<int, long long> m;
+    unsigned seed = 11;
+    for (int step = 0; step < 30000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int op = seed >> 16 & 3, key = (int) (seed >> 4 & 1023) - 512;
+        if (op == 0) {
+            bool fresh = f.insert(sjtu::flat_map<int, long long>::value_type(key, step)).second;
+            if (fresh != m.insert(std::make_pair(key, (long long) step)).second) return false;
+        } else if (op == 1) {
+            f[key] += step;
+            m[key] += step;
+        } else if (op == 2) {
+            if (f.erase(key) != m.erase(key)) return false;
+        } else if (f.count(key) != m.count(key)) {
+            return false;
+        }
+    }
+    if (f.size() != m.size()) return false;
+    std::map<int, long long>::iterator it = m.begin();
+    for (sjtu::flat_map<int, long long>::iterator p = f.begin(); p != f.end(); ++p, ++it) {
+        if ((*p).first != it->first || (*p).second != it->second) return false;
+    }
+    return true;
+}
+
+bool testBulkInsert() {
+    std::vector<std::pair<int, std::string>> batch;
+    unsigned seed = 5;
+    for (int i = 0; i < 5000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        batch.push_back(std::make_pair((int) (seed >> 8 & 4095), std::to_string(i)));
+    }
+    sjtu::flat_map<int, std::string> f(batch.begin(), batch.begin() + 2500);
+    f.insert(batch.begin() + 2500, batch.end());
+    std::map<int, std::string> m;
+    for (size_t i = 0; i < batch.size(); i++) m.insert(batch[i]);  // the first of equal keys stays
+    if (f.size() != m.size()) return false;
+    std::map<int, std::string>::iterator it = m.begin();
+    for (sjtu::flat_map<int, std::string>::const_iterator p = f.cbegin(); p != f.cend(); ++p, ++it) {
+        if (p.key() != it->first || p.value() != it->second) return false;
+    }
+    // a sorted run past the old keys is appended without a merge
+    std::vector<std::pair<int, std::string>> tail;
+    for (int k = 5000; k < 5100; k++) tail.push_back(std::make_pair(k, std::string("t")));
+    f.insert(tail.begin(), tail.end());
+    f.insert(tail.begin(), tail.end());
+    f.insert(tail.end(), tail.end());
+    return f.size() == m.size() + 100 && f.at(5099) == "t" && (*(f.end() - 1)).first == 5099;
+}
+
+/**
+ * a value whose move may throw, and whose copies throw once the budget runs out
+ */
+struct fragile {
+    static int budget;
+    int x;
+
+    fragile(int x = 0) : x(x) {}
+
+    fragile(const fragile &other) : x(other.x) {
+        if (budget-- == 0) throw std::bad_alloc();
+    }
+
+    fragile(fragile &&other) noexcept(false) : x(other.x) {}
+
+    fragile &operator=(const fragile &) = default;
+};
+
+int fragile::budget = -1;
+
+bool testThrowingMerge() {
+    sjtu::flat_map<std::string, fragile> f;
+    for (int i = 0; i < 100; i++) f[std::to_string(i * 2)] = fragile(i);
+    std::vector<std::pair<std::string, fragile>> batch;
+    for (int i = 0; i < 50; i++) batch.push_back(std::make_pair(std::to_string(i * 4 + 1), fragile(-i)));
+    fragile::budget = 80;  // the 50 appended values, then 30 entries into the merge
+    bool caught = false;
+    try { f.insert(batch.begin(), batch.end()); } catch (const std::bad_alloc &) { caught = true; }
+    fragile::budget = -1;
+    if (!caught || f.size() != 100) return false;
+    std::string last;
+    for (sjtu::flat_map<std::string, fragile>::iterator p = f.begin(); p != f.end(); ++p) {
+        if (p != f.begin() && !(last < p.key())) return false;
+        if (p.key() != std::to_string(p.value().x * 2)) return false;
+        last = p.key();
+    }
+    f.insert(batch.begin(), batch.end());
+    return f.size() == 150 && f.at("197").x == -49;
+}
+
+bool testRanges() {
+    sjtu::flat_map<int, int, std::greater<int>> f;
+    for (int k = 0; k < 100; k += 2) f[k] = k * k;
+    int sum = 0, n = 0;
+    // keys in [30, 10], the map runs from large to small
+    for (sjtu::flat_map<int, int, std::greater<int>>::iterator p = f.lower_bound(30); p != f.upper_bound(10); ++p) {
+        sum += p.value(), n++;
+    }
+    if (n != 11 || sum != 4 * (5 * 5 + 6 * 6 + 7 * 7 + 8 * 8 + 9 * 9 + 10 * 10 + 11 * 11 + 12 * 12 + 13 * 13 + 14 * 14 + 15 * 15)) {
+        return false;
+    }
+    int caught = 0;
+    try { f.at(31); } catch (const sjtu::index_out_of_bound &) { caught++; }
+    const sjtu::flat_map<int, int, std::greater<int>> &c = f;
+    try { c[1]; } catch (const sjtu::index_out_of_bound &) { caught++; }
+    try { f.erase(f.end()); } catch (const sjtu::invalid_iterator &) { caught++; }
+    sjtu::flat_map<int, int, std::greater<int>>::iterator next = f.erase(f.find(98));
+    return caught == 3 && next.key() == 96 && c.find(98) == c.cend() && c.lower_bound(99) == c.cbegin() &&
+           f.lower_bound(-1) == f.end();
+}
+
+bool testSet() {
+    std::vector<std::string> words;
+    for (int i = 0; i < 300; i++) words.push_back(std::to_string(i * 7 % 200));
+    sjtu::flat_set<std::string> s(words.begin(), words.end());
+    s.insert(words.end(), words.end());
+    std::set<std::string> ref(words.begin(), words.end());
+    if (s.size() != ref.size() || !s.insert("zzz").second || s.insert("zzz").second) return false;
+    ref.insert("zzz");
+    std::set<std::string>::iterator it = ref.begin();
+    for (sjtu::flat_set<std::string>::iterator p = s.begin(); p != s.end(); ++p, ++it) {
+        if (*p != *it) return false;
+    }
+    int between = 0;
+    for (sjtu::flat_set<std::string>::iterator p = s.lower_bound("10"); p != s.upper_bound("11"); ++p) between++;
+    s.erase(s.find("10"));
+    sjtu::flat_set<std::string> t;
+    swap(s, t);
+    return between == 12 && s.empty() && t.count("10") == 0 && t.erase("11") == 1 && t.size() == ref.size() - 2;
+}
+
+int main() {
+    std::cout << (testAgainstMap() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testBulkInsert() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testThrowingMerge() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testRanges() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testSet() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
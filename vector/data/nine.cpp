@@ -0,0 +1,128 @@
+#define SJTU_STATS
+
+#include "stable_vector.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static_assert(std::is_nothrow_move_constructible<sjtu::stable_vector<std::string>>::value, "move may not throw");
+
+bool testStableAddresses() {
+    sjtu::stable_vector<std::string> v;
+    v.push_back("first");
+    const std::string *first = &v[0];
+    std::vector<const std::string *> seen;
+    for (int i = 0; i < 100000; i++) {
+        if (i % 3 == 0) v.push_front(std::to_string(i));
+        else v.push_back(std::to_string(i));
+        if (i % 1000 == 0) seen.push_back(i % 3 == 0 ? &v.front() : &v.back());
+    }
+    for (size_t k = 0; k < seen.size(); k++) {
+        if (*seen[k] != std::to_string(k * 1000)) return false;
+    }
+    for (int i = 0; i < 30000; i++) v.pop_back();
+    return *first == "first" && v.stats().moves == 0;
+}
+
+bool testSteadyFifo() {
+    // a queue of 5000 strings through either end stops allocating once it has settled
+    sjtu::stable_vector<std::string> back, front;
+    long long next = 0, expect = 0;
+    for (; next < 5000; next++) back.push_back(std::to_string(next)), front.push_front(std::to_string(next));
+    for (int round = 0; round < 2; round++) {
+        back.reset_stats();
+        front.reset_stats();
+        for (int i = 0; i < 100000; i++, next++, expect++) {
+            if (back.front() != std::to_string(expect) || front.back() != std::to_string(expect)) return false;
+            back.pop_front(), front.pop_back();
+            back.push_back(std::to_string(next)), front.push_front(std::to_string(next));
+        }
+    }
+    long long i = expect;
+    for (sjtu::stable_vector<std::string>::iterator it = back.begin(); it != back.end(); ++it, ++i) {
+        if (*it != std::to_string(i) || front[front.size() - 1 - (i - expect)] != *it) return false;
+    }
+    return back.stats().allocations == 0 && front.stats().allocations == 0 && i == next;
+}
+
+bool testAgainstDeque() {
+    std::mt19937 rng(42);
+    sjtu::stable_vector<int> v;
+    std::deque<int> d;
+    for (int step = 0; step < 200000; step++) {
+        int op = rng() % 10, x = rng();
+        if (op < 3) v.push_back(x), d.push_back(x);
+        else if (op < 5) v.push_front(x), d.push_front(x);
+        else if (op < 6 && !d.empty()) v.pop_back(), d.pop_back();
+        else if (op < 7 && !d.empty()) v.pop_front(), d.pop_front();
+        else if (op < 8 && d.size() < 2000) {
+            size_t at = rng() % (d.size() + 1);
+            v.insert(at, x), d.insert(d.begin() + at, x);
+        } else if (op < 9 && !d.empty() && d.size() < 2000) {
+            size_t at = rng() % d.size();
+            v.erase(v.begin() + (int) at), d.erase(d.begin() + at);
+        } else if (!d.empty()) {
+            size_t at = rng() % d.size();
+            if (v[at] != d[at]) return false;
+        }
+        if (v.size() != d.size()) return false;
+    }
+    for (size_t i = 0; i < d.size(); i++) {
+        if (v.at(i) != d[i]) return false;
+    }
+    return true;
+}
+
+bool testIterators() {
+    sjtu::stable_vector<int> v;
+    for (int i = 0; i < 1000; i++) v.push_front(i * 7919 % 1000);
+    std::sort(v.begin(), v.end());
+    for (int i = 0; i < 1000; i++) {
+        if (v[i] != i) return false;
+    }
+    long long sum = 0;
+    const sjtu::stable_vector<int> &c = v;
+    for (sjtu::stable_vector<int>::const_iterator it = c.cbegin(); it != c.cend(); ++it) sum += *it;
+    return sum == 999 * 1000 / 2 && v.end() - v.begin() == 1000 && *(v.begin() + 10) == 10;
+}
+
+bool testExceptions() {
+    sjtu::stable_vector<int> v, w;
+    int caught = 0;
+    try { v.pop_back(); } catch (const sjtu::container_is_empty &) { caught++; }
+    try { v.pop_front(); } catch (const sjtu::container_is_empty &) { caught++; }
+    try { v.front(); } catch (const sjtu::container_is_empty &) { caught++; }
+    v.push_back(1);
+    try { v[1]; } catch (const sjtu::index_out_of_bound &) { caught++; }
+    try { v.insert(2, 0); } catch (const sjtu::index_out_of_bound &) { caught++; }
+    try { v.erase(w.begin()); } catch (const sjtu::invalid_iterator &) { caught++; }
+    return caught == 6;
+}
+
+bool testCopyMove() {
+    sjtu::stable_vector<std::string> a;
+    for (int i = 0; i < 100; i++) a.push_front(std::to_string(i));
+    sjtu::stable_vector<std::string> b(a), c;
+    c = b;
+    const std::string *p = &c[50];
+    sjtu::stable_vector<std::string> d(std::move(c));
+    if (&d[50] != p || !c.empty()) return false;
+    swap(a, c);
+    c.push_back(c[0]);
+    return a.empty() && c.size() == 101 && b.back() == "0" && c.back() == "99" && d[0] == "99";
+}
+
+int main() {
+    std::cout << (testStableAddresses() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testSteadyFifo() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testAgainstDeque() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testIterators() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testExceptions() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testCopyMove() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
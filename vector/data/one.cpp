@@ -1,4 +1,4 @@
-#include "zfy.hpp"
+#include "vector.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -0,0 +1,89 @@
+#define SJTU_STATS
+
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_nothrow_move_constructible<sjtu::vector<int>>::value, "vector move may not throw");
+static_assert(std::is_nothrow_move_assignable<sjtu::vector<int>>::value, "vector move may not throw");
+
+sjtu::vector<std::string> make(int n) {
+    sjtu::vector<std::string> v;
+    for (int i = 0; i < n; i++) v.push_back(std::to_string(i));
+    return v;
+}
+
+bool testMove() {
+    sjtu::vector<std::string> a = make(100);
+    const std::string *data = &a[0];
+    sjtu::vector<std::string> b(std::move(a));
+    if (!a.empty() || b.size() != 100 || &b[0] != data || b[99] != "99") return false;
+    if (b.stats().allocations != 0) return false;
+    a.push_back("again");
+    a = std::move(b);
+    if (!b.empty() || a.size() != 100 || &a[0] != data || a[0] != "0") return false;
+    b = make(3);
+    b = std::move(b);
+    return b.size() == 3 && b[2] == "2";
+}
+
+bool testSwap() {
+    sjtu::vector<int> a, b;
+    for (int i = 0; i < 10; i++) a.push_back(i);
+    b.push_back(-1);
+    const int *data = &a[0];
+    swap(a, b);
+    if (a.size() != 1 || a[0] != -1 || b.size() != 10 || &b[0] != data) return false;
+    a.swap(b);
+    return a.size() == 10 && b.size() == 1 && a[9] == 9;
+}
+
+bool testNestedGrowth() {
+    // growing the outer vector moves the inner ones instead of copying their elements
+    sjtu::vector<sjtu::vector<int>> outer;
+    const int *first = nullptr;
+    for (int i = 0; i < 1000; i++) {
+        sjtu::vector<int> inner;
+        for (int j = 0; j <= i % 10; j++) inner.push_back(i + j);
+        outer.push_back(std::move(inner));
+        if (i == 0) first = &outer[0][0];
+    }
+    for (int i = 0; i < 1000; i++) {
+        if (outer[i].size() != (size_t) (i % 10 + 1) || outer[i][0] != i) return false;
+    }
+    outer.insert(500, outer[0]);
+    outer.erase(0);
+    return &outer[499][0] != first && outer[499][0] == 0 && outer[0][0] == 1 && outer.size() == 1000;
+}
+
+bool testAliasing() {
+    // the pushed value lives in the buffer that the push reallocates
+    sjtu::vector<std::string> v;
+    for (int i = 0; i < 5; i++) v.push_back(std::string(40, 'a' + i));
+    v.push_back(v[0]);
+    v.insert(0, v[5]);
+    v.insert(3, v[0]);
+    return v.size() == 8 && v[0] == std::string(40, 'a') && v[6] == std::string(40, 'e') &&
+           v[3] == std::string(40, 'a') && v[7] == std::string(40, 'a');
+}
+
+bool testCopyAssign() {
+    // the target has room for the source, bigger and smaller than it
+    sjtu::vector<std::string> a = make(10), b = make(3), c = make(20);
+    c = b;
+    if (c.size() != 3 || c[2] != "2") return false;
+    b = a;
+    c = a;
+    return b.size() == 10 && c.size() == 10 && b[9] == "9" && c[9] == "9";
+}
+
+int main() {
+    std::cout << (testMove() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testSwap() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testNestedGrowth() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testAliasing() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testCopyAssign() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
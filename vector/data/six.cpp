@@ -0,0 +1,34 @@
+#define SJTU_STATS
+
+#include "vector.hpp"
+
+#include <iostream>
+
+bool testGrowth() {
+    sjtu::vector<long long> v;
+    for (int i = 0; i < 100; i++) v.push_back(i);
+    // capacities 5, 10, 20, 40, 80, 160: the last five copy 5 + 10 + 20 + 40 + 80 elements
+    sjtu::vector<long long>::statistics s = v.stats();
+    if (s.allocations != 6 || s.reallocations != 6 || s.moves != 155) return false;
+    if (s.bytes_allocated != (6 + 11 + 21 + 41 + 81 + 161) * sizeof(long long)) return false;
+    v.reset_stats();
+    v.insert(90, -1);
+    v.erase(v.begin());
+    s = v.stats();
+    return s.allocations == 0 && s.reallocations == 0 && s.moves == 10 + 100;
+}
+
+bool testCopy() {
+    sjtu::vector<int> v;
+    for (int i = 0; i < 10; i++) v.push_back(i);
+    sjtu::vector<int> copy(v), assigned;
+    assigned = v;
+    assigned = v;
+    return copy.stats().allocations == 1 && copy.stats().moves == 0 && assigned.stats().allocations == 1;
+}
+
+int main() {
+    std::cout << (testGrowth() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testCopy() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -0,0 +1,128 @@
+#define SJTU_STATS
+
+#include "soa_vector.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+typedef sjtu::soa_vector<long long, int, double, int> trades;  // timestamp, id, price, qty
+
+static_assert(std::is_nothrow_move_constructible<trades>::value, "soa_vector move may not throw");
+
+bool aligned(const void *p) {
+    return reinterpret_cast<uintptr_t>(p) % trades::column_alignment == 0;
+}
+
+bool testColumns() {
+    trades t;
+    for (int i = 0; i < 1000; i++) t.push_back(1000000LL + i, i, i * 0.5, i % 7);
+    if (t.size() != 1000 || t.capacity() % 16 != 0) return false;
+    if (!aligned(t.column<0>().data()) || !aligned(t.column<1>().data()) || !aligned(t.column<2>().data()))
+        return false;
+    double total = 0;
+    for (double price : t.column<2>()) total += price;
+    long long big = 0;
+    sjtu::soa_span<int> qty = t.column<3>();
+    for (size_t i = 0; i < qty.size(); i++) big += qty[i] > 3;
+    return total == 999 * 1000 / 4.0 && big == 428 && t.column<1>()[999] == 999;
+}
+
+bool testRows() {
+    trades t;
+    t.push_back(std::make_tuple(1LL, 2, 3.0, 4));
+    t.push_back(5, 6, 7.0, 8);
+    t[0].get<2>() = 9.5;
+    t[1] = std::make_tuple(10LL, 11, 12.0, 13);
+    std::tuple<long long, int, double, int> row = t[0];
+    const trades &c = t;
+    if (std::get<2>(row) != 9.5 || c[1].get<0>() != 10 || c.back().get<3>() != 13) return false;
+    t.push_back(t[0]);
+    t.erase(0);
+    t[0] = t[1];
+    int caught = 0;
+    try { t.at(2); } catch (const sjtu::index_out_of_bound &) { caught++; }
+    try { t[5].get<0>(); } catch (const sjtu::index_out_of_bound &) { caught++; }
+    try { t.column<0>()[2]; } catch (const sjtu::index_out_of_bound &) { caught++; }
+    t.pop_back();
+    t.pop_back();
+    try { t.pop_back(); } catch (const sjtu::container_is_empty &) { caught++; }
+    try { t.front(); } catch (const sjtu::container_is_empty &) { caught++; }
+    return caught == 5 && t.empty();
+}
+
+bool testGrowthAndCopy() {
+    sjtu::soa_vector<std::string, int> names;
+    for (int i = 0; i < 100; i++) names.push_back(std::to_string(i), i);
+    // pushing a row of the vector itself while it grows
+    names.push_back(names[0].get<0>(), names[0].get<1>());
+    // moving std::string never throws, so growth moved every field once
+    sjtu::soa_vector<std::string, int>::statistics grown = names.stats();
+    if (grown.reallocations != 4 || grown.moves != (16 + 32 + 64) * 2) return false;
+    sjtu::soa_vector<std::string, int> copy(names), moved(std::move(names));
+    if (!names.empty() || copy.size() != 101 || moved[100].get<0>() != "0" || copy[57].get<0>() != "57")
+        return false;
+    swap(copy, names);
+    names.reserve(1000);
+    if (names.capacity() < 1000 || names[99].get<0>() != "99") return false;
+    copy = names;
+    names.clear();
+    return copy.size() == 101 && names.empty() && moved.size() == 101;
+}
+
+/**
+ * a field whose move may throw, and whose copies throw once the budget runs out
+ */
+struct fragile {
+    static int budget, live;
+    std::string s;
+
+    fragile(const std::string &s) : s(s) { live++; }
+
+    fragile(const fragile &other) : s(other.s) {
+        if (budget-- == 0) throw std::bad_alloc();
+        live++;
+    }
+
+    fragile(fragile &&other) noexcept(false) : s(std::move(other.s)) { live++; }
+
+    fragile &operator=(const fragile &) = default;
+
+    ~fragile() { live--; }
+};
+
+int fragile::budget = -1, fragile::live = 0;
+
+bool testThrowingGrowth() {
+    {
+        sjtu::soa_vector<std::string, fragile> v;
+        for (int i = 0; i < 16; i++) v.push_back(std::string(30, 'a' + i), std::string(30, 'A' + i));
+        int caught = 0;
+        // growing copies the 16 fragile fields: throw on the first copy and part way through
+        fragile::budget = 0;
+        try { v.push_back("x", std::string("y")); } catch (const std::bad_alloc &) { caught++; }
+        fragile::budget = 7;
+        try { v.push_back("x", std::string("y")); } catch (const std::bad_alloc &) { caught++; }
+        fragile::budget = 5;
+        try { v.reserve(100); } catch (const std::bad_alloc &) { caught++; }
+        fragile::budget = -1;
+        if (caught != 3 || v.size() != 16 || v.capacity() != 16 || fragile::live != 16) return false;
+        v.push_back("x", std::string("y"));
+        for (int i = 0; i < 16; i++) {
+            if (v[i].get<0>() != std::string(30, 'a' + i) || v[i].get<1>().s != std::string(30, 'A' + i)) return false;
+        }
+        if (v.size() != 17 || v.capacity() != 32 || v.back().get<1>().s != "y") return false;
+    }
+    return fragile::live == 0;
+}
+
+int main() {
+    std::cout << (testColumns() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testRows() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testGrowthAndCopy() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testThrowingGrowth() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
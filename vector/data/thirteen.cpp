@@ -0,0 +1,101 @@
+#include "static_vector.hpp"
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct point {
+    int x = -1, y = -1;  // not trivial, but trivially copyable
+
+    point() {}
+
+    point(int a, int b) : x(a), y(b) {}
+};
+
+static_assert(std::is_trivially_copyable<sjtu::static_vector<int, 8>>::value, "int elements copy as bytes");
+static_assert(std::is_trivially_copyable<sjtu::static_vector<point, 8>>::value, "point elements copy as bytes");
+static_assert(!std::is_trivially_copyable<sjtu::static_vector<std::string, 8>>::value, "strings are copied one by one");
+static_assert(sizeof(sjtu::static_vector<int, 8>) == 8 * sizeof(int) + sizeof(size_t), "no storage besides the elements");
+static_assert(sjtu::static_vector<int, 8>::capacity() == 8, "the capacity is the bound");
+
+/**
+ * a table built at compile time: the squares that are also 1 modulo 3, in order
+ */
+constexpr sjtu::static_vector<int, 32> make_table() {
+    sjtu::static_vector<int, 32> table;
+    for (int i = 0; i < 40 && !table.full(); i++) {
+        if (i * i % 3 == 1) table.push_back(i * i);
+    }
+    table.insert_at(0, -1);
+    table.erase_at(1);
+    table.pop_back();
+    return table;
+}
+
+constexpr sjtu::static_vector<int, 32> table = make_table();
+static_assert(table.size() == 25 && table[0] == -1 && table[1] == 4 && table.back() == 1369, "built at compile time");
+
+bool testAgainstVector() {
+    sjtu::static_vector<int, 64> s;
+    std::vector<int> v;
+    unsigned seed = 7;
+    for (int step = 0; step < 20000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int op = seed >> 16 & 3, x = (int) (seed >> 8);
+        if (op < 2 && v.size() < 64) {
+            size_t at = x % (v.size() + 1);
+            s.insert(s.begin() + (int) at, x);
+            v.insert(v.begin() + at, x);
+        } else if (op == 2 && !v.empty()) {
+            size_t at = x % v.size();
+            s.erase(at);
+            v.erase(v.begin() + at);
+        } else if (!v.empty()) {
+            s.pop_back();
+            v.pop_back();
+        }
+        if (s.size() != v.size()) return false;
+    }
+    for (size_t i = 0; i < v.size(); i++) {
+        if (s[i] != v[i]) return false;
+    }
+    return true;
+}
+
+bool testBounds() {
+    sjtu::static_vector<point, 4> s(3, point(1, 2));
+    s.emplace_back(3, 4);
+    int caught = 0;
+    try { s.push_back(point()); } catch (const sjtu::runtime_error &) { caught++; }
+    try { s.insert(0, point()); } catch (const sjtu::runtime_error &) { caught++; }
+    try { s.at(4); } catch (const sjtu::index_out_of_bound &) { caught++; }
+    try { sjtu::static_vector<int, 2> big(3, 0); } catch (const sjtu::runtime_error &) { caught++; }
+    sjtu::static_vector<point, 4> copy = s;
+    s.clear();
+    try { s.pop_back(); } catch (const sjtu::container_is_empty &) { caught++; }
+    try { s.front(); } catch (const sjtu::container_is_empty &) { caught++; }
+    return caught == 6 && copy.size() == 4 && copy.back().y == 4 && copy.full();
+}
+
+bool testStrings() {
+    sjtu::static_vector<std::string, 16> a, b;
+    for (int i = 0; i < 10; i++) a.push_back(std::string(30, 'a' + i));
+    a.insert(0, a[9]);  // the value lives in the vector itself
+    b.push_back("b");
+    sjtu::static_vector<std::string, 16> c(a), d(std::move(b));
+    swap(a, d);
+    if (a.size() != 1 || a[0] != "b" || d.size() != 11 || d[0] != std::string(30, 'j')) return false;
+    c = a;
+    a = std::move(d);
+    long long letters = 0;
+    for (sjtu::static_vector<std::string, 16>::iterator it = a.begin(); it != a.end(); ++it) letters += (*it).size();
+    return c.size() == 1 && c[0] == "b" && letters == 11 * 30 && a.end() - a.begin() == 11;
+}
+
+int main() {
+    std::cout << (testAgainstVector() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testBounds() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testStrings() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
@@ -1,4 +1,4 @@
-#include "zfy.hpp"
+#include "vector.hpp"
 
 #include "class-integer.hpp"
 #include "class-matrix.hpp"
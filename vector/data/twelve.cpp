@@ -0,0 +1,109 @@
+#include "concurrent_vector.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int THREADS = 8;
+const int PER_THREAD = 20000;
+
+bool testPushers() {
+    sjtu::concurrent_vector<long long> v;
+    std::atomic<bool> done(false);
+    std::atomic<bool> reader_ok(true);
+    // a reader checks whatever is published while the producers run
+    std::thread reader([&]() {
+        while (!done.load()) {
+            size_t n = v.size();
+            for (size_t i = 0; i < n; i += 97) {
+                if (!v.published(i)) continue;
+                long long x = v[i];
+                if (x < 0 || x >= (long long) THREADS * PER_THREAD) reader_ok = false;
+            }
+        }
+    });
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; t++) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < PER_THREAD; i++) {
+                size_t at = v.push_back((long long) t * PER_THREAD + i);
+                if (v[at] != (long long) t * PER_THREAD + i) reader_ok = false;
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    done = true;
+    reader.join();
+    if (!reader_ok || v.size() != THREADS * PER_THREAD) return false;
+    std::vector<bool> seen(THREADS * PER_THREAD, false);
+    std::vector<int> last(THREADS, -1);
+    for (size_t i = 0; i < v.size(); i++) {
+        long long x = v.at(i);
+        if (seen[x]) return false;
+        seen[x] = true;
+        // each producer's elements keep their order
+        int t = (int) (x / PER_THREAD), k = (int) (x % PER_THREAD);
+        if (k <= last[t]) return false;
+        last[t] = k;
+    }
+    return true;
+}
+
+bool testStableAndGrowBy() {
+    sjtu::concurrent_vector<std::string> v;
+    v.reserve(100);
+    v.push_back("zero");
+    const std::string *first = &v[0];
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; t++) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < 100; i++) {
+                size_t at = v.grow_by(10, std::to_string(t));
+                for (size_t j = at; j < at + 10; j++) v[j] += "!";
+            }
+            v.emplace_back(3, 'x');
+        });
+    }
+    for (auto &w : workers) w.join();
+    if (&v[0] != first || v.size() != 1 + THREADS * 1001) return false;
+    size_t marked = 0, xs = 0;
+    for (size_t i = 1; i < v.size(); i++) {
+        marked += v[i].size() == 2 && v[i][1] == '!';
+        xs += v[i] == "xxx";
+    }
+    size_t at = v.grow_by(5);
+    return marked == THREADS * 1000 && xs == THREADS && v[at + 4].empty();
+}
+
+struct fragile {
+    int x;
+
+    fragile(int value) : x(value) {
+        if (value < 0) throw value;
+    }
+};
+
+bool testErrors() {
+    sjtu::concurrent_vector<fragile> v;
+    int caught = 0;
+    try { v.at(0); } catch (const sjtu::index_out_of_bound &) { caught++; }
+    v.emplace_back(1);
+    try { v.emplace_back(-1); } catch (int) { caught++; }
+    // the slot of the failed push is handed out but never published
+    if (v.size() != 2 || v.published(1) || !v.published(0)) return false;
+    try { v[1]; } catch (const sjtu::index_out_of_bound &) { caught++; }
+    v.emplace_back(2);
+    if (v[2].x != 2) return false;
+    v.clear();
+    v.emplace_back(5);
+    return caught == 3 && v.size() == 1 && v[0].x == 5 && !v.empty();
+}
+
+int main() {
+    std::cout << (testPushers() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testStableAndGrowBy() ? "OKAY" : "FAIL") << std::endl;
+    std::cout << (testErrors() ? "OKAY" : "FAIL") << std::endl;
+    return 0;
+}
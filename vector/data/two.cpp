@@ -1,5 +1,5 @@
 #pragma GCC optimize(2)
-#include "zfy.hpp"
+#include "vector.hpp"
 
 #include <iostream>
 
@@ -0,0 +1,142 @@
+#ifndef SJTU_EYTZINGER_INDEX_HPP
+#define SJTU_EYTZINGER_INDEX_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+    /**
+     * a read-only search index over sorted data in Eytzinger (BFS) order:
+     * node k has its sons at 2k and 2k + 1, so the first levels of every search
+     * share the same few cache lines and the next levels can be prefetched.
+     * the descent is branchless and the answers are positions in the sorted input.
+     */
+    template<typename T, class Compare = std::less<T>>
+    class eytzinger_index {
+    private:
+        /**
+         * nodes that fit in a cache line, the descent prefetches this many levels' worth ahead
+         */
+        static const size_t line = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+
+        T *_tree;
+        size_t *_pos;
+        size_t _size;
+        Compare cmp;
+
+        static T *allocate(size_t n) {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(64)));
+        }
+
+        /**
+         * fill node k and its subtree by in-order traversal, i is the next sorted position
+         */
+        void build(const T *sorted, size_t &i, size_t k) {
+            if (k > _size) return;
+            build(sorted, i, 2 * k);
+            new(_tree + k) T(sorted[i]);
+            _pos[k] = i++;
+            build(sorted, i, 2 * k + 1);
+        }
+
+        void init(const T *sorted, size_t n) {
+            _size = n;
+            _tree = allocate(n + 1);
+            _pos = new size_t[n + 1];
+            _pos[0] = n;
+            size_t i = 0;
+            build(sorted, i, 1);
+        }
+
+        void release() {
+            for (size_t k = 1; k <= _size; k++) _tree[k].~T();
+            ::operator delete(_tree, std::align_val_t(64));
+            delete[] _pos;
+        }
+
+        /**
+         * descend while going right if less(node) holds, then drop the trailing right
+         * turns plus one: the result is the last node where the search went left, or 0.
+         */
+        template<class Less>
+        size_t descend(Less less) const {
+            size_t k = 1;
+            while (k <= _size) {
+#if defined(__GNUC__)
+                __builtin_prefetch(_tree + k * line);
+#endif
+                k = 2 * k + (less(_tree[k]) ? 1 : 0);
+            }
+#if defined(__GNUC__)
+            return k >> (__builtin_ctzll(~(unsigned long long) k) + 1);
+#else
+            while (k & 1) k >>= 1;
+            return k >> 1;
+#endif
+        }
+
+    public:
+        /**
+         * build from a vector sorted by Compare.
+         */
+        explicit eytzinger_index(const vector<T> &sorted, const Compare &c = Compare()) : cmp(c) {
+            init(sorted.empty() ? nullptr : &sorted[0], sorted.size());
+        }
+
+        eytzinger_index(const T *first, const T *last, const Compare &c = Compare()) : cmp(c) {
+            init(first, last - first);
+        }
+
+        eytzinger_index(const eytzinger_index &other) : _size(other._size), cmp(other.cmp) {
+            _tree = allocate(_size + 1);
+            _pos = new size_t[_size + 1];
+            _pos[0] = _size;
+            for (size_t k = 1; k <= _size; k++) {
+                new(_tree + k) T(other._tree[k]);
+                _pos[k] = other._pos[k];
+            }
+        }
+
+        eytzinger_index &operator=(const eytzinger_index &other) {
+            if (this == &other) return *this;
+            eytzinger_index tmp(other);
+            std::swap(_tree, tmp._tree);
+            std::swap(_pos, tmp._pos);
+            std::swap(_size, tmp._size);
+            std::swap(cmp, tmp.cmp);
+            return *this;
+        }
+
+        ~eytzinger_index() { release(); }
+
+        /**
+         * position of the first element not less than x, size() if there is none.
+         */
+        size_t lower_bound(const T &x) const {
+            return _pos[descend([this, &x](const T &node) { return cmp(node, x); })];
+        }
+
+        /**
+         * position of the first element greater than x, size() if there is none.
+         */
+        size_t upper_bound(const T &x) const {
+            return _pos[descend([this, &x](const T &node) { return !cmp(x, node); })];
+        }
+
+        bool contains(const T &x) const {
+            size_t k = descend([this, &x](const T &node) { return cmp(node, x); });
+            return k != 0 && !cmp(x, _tree[k]);
+        }
+
+        size_t size() const { return _size; }
+
+        bool empty() const { return _size == 0; }
+    };
+}
+
+#endif
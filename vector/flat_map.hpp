@@ -0,0 +1,564 @@
+#ifndef SJTU_FLAT_MAP_HPP
+#define SJTU_FLAT_MAP_HPP
+
+#include "algorithm.hpp"
+#include "exceptions.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+    namespace detail {
+        /**
+         * the merge behind flat_map / flat_set bulk insert: keys [0, n) are sorted and
+         * unique, [n, n + m) were just appended. emit(i) is called for every entry of the
+         * merged result in order, taking an old entry over an equal new one and the first
+         * of equal new ones.
+         * returns false without calling emit when the appended run is empty, or already
+         * sorted, unique and past the old keys, i.e. the arrays are fine as they are.
+         */
+        template<class Key, class Compare, class Emit>
+        bool flat_merge(const Key *keys, size_t n, size_t m, Compare &cmp, Emit emit) {
+            if (m == 0) return false;
+            bool in_place = n == 0 || cmp(keys[n - 1], keys[n]);
+            for (size_t i = n + 1; in_place && i < n + m; i++) in_place = cmp(keys[i - 1], keys[i]);
+            if (in_place) return false;
+            vector<size_t> order;
+            for (size_t i = n; i < n + m; i++) order.push_back(i);
+            size_t *o = order.data();
+            sjtu::stable_sort(o, o + m, [keys, &cmp](size_t a, size_t b) { return cmp(keys[a], keys[b]); });
+            size_t i = 0, j = 0;
+            while (i < n || j < m) {
+                size_t from = j == m || (i < n && !cmp(keys[o[j]], keys[i])) ? i++ : o[j++];
+                while (j < m && !cmp(keys[from], keys[o[j]])) j++;
+                emit(from);
+            }
+            return true;
+        }
+    }
+
+    /**
+     * a sorted map kept in two sjtu::vectors, one of keys and one of values, for small
+     * and read-mostly dictionaries: an entry costs sizeof(Key) + sizeof(T), lookups are
+     * a branchless binary search over the keys and iteration is a linear scan in key order.
+     * inserting or erasing one entry is O(n); build large maps with insert(first, last),
+     * which appends, sorts and merges in O(n + m log m).
+     * iterators are invalidated by every insert and erase; at() on a missing key throws
+     * index_out_of_bound, like linked_hashmap.
+     */
+    template<class Key, class T, class Compare = std::less<Key>>
+    class flat_map {
+    public:
+        typedef pair<const Key, T> value_type;
+
+    private:
+        vector<Key> _keys;
+        vector<T> _values;
+        Compare cmp;
+
+        /**
+         * the first position whose key is not less than key
+         */
+        size_t lower(const Key &key) const {
+            const Key *k = _keys.data();
+            return sjtu::lower_bound(k, k + _keys.size(), key, cmp) - k;
+        }
+
+        size_t upper(const Key &key) const {
+            const Key *k = _keys.data();
+            return sjtu::upper_bound(k, k + _keys.size(), key, cmp) - k;
+        }
+
+        bool found(size_t pos, const Key &key) const {
+            return pos < _keys.size() && !cmp(key, _keys.data()[pos]);
+        }
+
+        void insert_at(size_t pos, const Key &key, const T &value) {
+            _keys.insert(pos, key);
+            try {
+                _values.insert(pos, value);
+            } catch (...) {
+                _keys.erase(pos);
+                throw;
+            }
+        }
+
+        void truncate(size_t n) {
+            while (_keys.size() > n) _keys.pop_back();
+            while (_values.size() > n) _values.pop_back();
+        }
+
+        /**
+         * an entry leaves the old arrays by move only if neither its key nor its value
+         * can throw on a move, so that a merge that throws leaves them intact.
+         */
+        static const bool move_entries = std::is_nothrow_move_constructible<Key>::value &&
+                                         std::is_nothrow_move_constructible<T>::value;
+
+        template<class U>
+        static typename std::conditional<move_entries, U &&, const U &>::type take(U &x) {
+            return static_cast<typename std::conditional<move_entries, U &&, const U &>::type>(x);
+        }
+
+    public:
+        class const_iterator;
+
+        /**
+         * a position in both arrays; *it is a pair of references to the key and the value.
+         */
+        class iterator {
+            friend class flat_map;
+            friend class const_iterator;
+
+        private:
+            const Key *_key;
+            T *_value;
+
+            iterator(const Key *key, T *value) : _key(key), _value(value) {}
+
+        public:
+            iterator() : _key(nullptr), _value(nullptr) {}
+
+            const Key &key() const { return *_key; }
+
+            T &value() const { return *_value; }
+
+            pair<const Key &, T &> operator*() const {
+                return pair<const Key &, T &>(*_key, *_value);
+            }
+
+            iterator operator+(const int &n) const { return iterator(_key + n, _value + n); }
+
+            iterator operator-(const int &n) const { return iterator(_key - n, _value - n); }
+
+            int operator-(const iterator &rhs) const { return _key - rhs._key; }
+
+            iterator &operator++() {
+                _key++, _value++;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            iterator &operator--() {
+                _key--, _value--;
+                return *this;
+            }
+
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            bool operator==(const iterator &rhs) const { return _key == rhs._key; }
+
+            bool operator!=(const iterator &rhs) const { return _key != rhs._key; }
+
+            bool operator==(const const_iterator &rhs) const { return _key == rhs._key; }
+
+            bool operator!=(const const_iterator &rhs) const { return _key != rhs._key; }
+        };
+
+        class const_iterator {
+            friend class flat_map;
+            friend class iterator;
+
+        private:
+            const Key *_key;
+            const T *_value;
+
+            const_iterator(const Key *key, const T *value) : _key(key), _value(value) {}
+
+        public:
+            const_iterator() : _key(nullptr), _value(nullptr) {}
+
+            const_iterator(const iterator &other) : _key(other._key), _value(other._value) {}
+
+            const Key &key() const { return *_key; }
+
+            const T &value() const { return *_value; }
+
+            pair<const Key &, const T &> operator*() const {
+                return pair<const Key &, const T &>(*_key, *_value);
+            }
+
+            const_iterator operator+(const int &n) const { return const_iterator(_key + n, _value + n); }
+
+            const_iterator operator-(const int &n) const { return const_iterator(_key - n, _value - n); }
+
+            int operator-(const const_iterator &rhs) const { return _key - rhs._key; }
+
+            const_iterator &operator++() {
+                _key++, _value++;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            const_iterator &operator--() {
+                _key--, _value--;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            bool operator==(const const_iterator &rhs) const { return _key == rhs._key; }
+
+            bool operator!=(const const_iterator &rhs) const { return _key != rhs._key; }
+        };
+
+    private:
+        iterator at_position(size_t pos) {
+            return iterator(_keys.data() + pos, _values.data() + pos);
+        }
+
+        const_iterator at_position(size_t pos) const {
+            return const_iterator(_keys.data() + pos, _values.data() + pos);
+        }
+
+    public:
+        flat_map() {}
+
+        explicit flat_map(const Compare &compare) : cmp(compare) {}
+
+        template<class InputIt>
+        flat_map(InputIt first, InputIt last) {
+            insert(first, last);
+        }
+
+        void swap(flat_map &other) noexcept {
+            _keys.swap(other._keys);
+            _values.swap(other._values);
+            std::swap(cmp, other.cmp);
+        }
+
+        T &at(const Key &key) {
+            size_t pos = lower(key);
+            if (!found(pos, key)) throw sjtu::index_out_of_bound();
+            return _values[pos];
+        }
+
+        const T &at(const Key &key) const {
+            size_t pos = lower(key);
+            if (!found(pos, key)) throw sjtu::index_out_of_bound();
+            return _values[pos];
+        }
+
+        /**
+         * the value of key, inserting T() first if key is missing.
+         */
+        T &operator[](const Key &key) {
+            size_t pos = lower(key);
+            if (!found(pos, key)) insert_at(pos, key, T());
+            return _values[pos];
+        }
+
+        const T &operator[](const Key &key) const {
+            return at(key);
+        }
+
+        iterator begin() {
+            return at_position(0);
+        }
+
+        const_iterator cbegin() const {
+            return at_position(0);
+        }
+
+        iterator end() {
+            return at_position(_keys.size());
+        }
+
+        const_iterator cend() const {
+            return at_position(_keys.size());
+        }
+
+        bool empty() const {
+            return _keys.empty();
+        }
+
+        size_t size() const {
+            return _keys.size();
+        }
+
+        void clear() {
+            _keys.clear();
+            _values.clear();
+        }
+
+        /**
+         * insert value unless its key is present; the bool tells whether it was inserted
+         * and the iterator points at the entry with that key either way.
+         */
+        pair<iterator, bool> insert(const value_type &value) {
+            size_t pos = lower(value.first);
+            if (found(pos, value.first)) return pair<iterator, bool>(at_position(pos), false);
+            insert_at(pos, value.first, value.second);
+            return pair<iterator, bool>(at_position(pos), true);
+        }
+
+        /**
+         * insert every (*it).first, (*it).second of [first, last) whose key is not present;
+         * of equal keys in the range the first one is kept.
+         * the entries are appended, the new run is sorted and merged with the old one in
+         * a single pass; a run that is already sorted and past the old keys is not moved.
+         * if anything throws the map is left as it was.
+         */
+        template<class InputIt>
+        void insert(InputIt first, InputIt last) {
+            size_t n = _keys.size();
+            try {
+                for (; first != last; ++first) {
+                    _keys.push_back((*first).first);
+                    _values.push_back((*first).second);
+                }
+                vector<Key> keys;
+                vector<T> values;
+                Key *k = _keys.data();
+                T *v = _values.data();
+                size_t total = _keys.size();
+                bool merged = detail::flat_merge(k, n, total - n, cmp, [&](size_t from) {
+                    if (keys.empty()) {
+                        // nothing may throw once the first entry has moved
+                        keys.reserve(total);
+                        values.reserve(total);
+                    }
+                    keys.push_back(take(k[from]));
+                    values.push_back(take(v[from]));
+                });
+                if (!merged) return;
+                _keys = std::move(keys);
+                _values = std::move(values);
+            } catch (...) {
+                truncate(n);
+                throw;
+            }
+        }
+
+        /**
+         * erase the entry at pos, return the iterator to the one after it.
+         */
+        iterator erase(iterator pos) {
+            size_t index = pos._key - _keys.data();
+            if (index >= _keys.size()) throw sjtu::invalid_iterator();
+            _keys.erase(index);
+            _values.erase(index);
+            return at_position(index);
+        }
+
+        /**
+         * erase the entry with key, return the number erased (0 or 1).
+         */
+        size_t erase(const Key &key) {
+            size_t pos = lower(key);
+            if (!found(pos, key)) return 0;
+            _keys.erase(pos);
+            _values.erase(pos);
+            return 1;
+        }
+
+        size_t count(const Key &key) const {
+            return found(lower(key), key) ? 1 : 0;
+        }
+
+        iterator find(const Key &key) {
+            size_t pos = lower(key);
+            return found(pos, key) ? at_position(pos) : end();
+        }
+
+        const_iterator find(const Key &key) const {
+            size_t pos = lower(key);
+            return found(pos, key) ? at_position(pos) : cend();
+        }
+
+        /**
+         * the first entry whose key is not less than key; with upper_bound this
+         * gives the entries of a key range, [lower_bound(lo), upper_bound(hi)).
+         */
+        iterator lower_bound(const Key &key) {
+            return at_position(lower(key));
+        }
+
+        const_iterator lower_bound(const Key &key) const {
+            return at_position(lower(key));
+        }
+
+        /**
+         * the first entry whose key is greater than key.
+         */
+        iterator upper_bound(const Key &key) {
+            return at_position(upper(key));
+        }
+
+        const_iterator upper_bound(const Key &key) const {
+            return at_position(upper(key));
+        }
+    };
+
+    template<class Key, class T, class Compare>
+    void swap(flat_map<Key, T, Compare> &a, flat_map<Key, T, Compare> &b) noexcept {
+        a.swap(b);
+    }
+
+    /**
+     * the set counterpart of flat_map: the keys in one sorted sjtu::vector, iterated
+     * read-only in key order.
+     */
+    template<class Key, class Compare = std::less<Key>>
+    class flat_set {
+    public:
+        typedef Key value_type;
+        typedef typename vector<Key>::const_iterator iterator;
+        typedef typename vector<Key>::const_iterator const_iterator;
+
+    private:
+        vector<Key> _keys;
+        Compare cmp;
+
+        size_t lower(const Key &key) const {
+            const Key *k = _keys.data();
+            return sjtu::lower_bound(k, k + _keys.size(), key, cmp) - k;
+        }
+
+        size_t upper(const Key &key) const {
+            const Key *k = _keys.data();
+            return sjtu::upper_bound(k, k + _keys.size(), key, cmp) - k;
+        }
+
+        bool found(size_t pos, const Key &key) const {
+            return pos < _keys.size() && !cmp(key, _keys.data()[pos]);
+        }
+
+        const_iterator at_position(size_t pos) const {
+            return const_iterator(_keys.data() + pos, _keys.data());
+        }
+
+    public:
+        flat_set() {}
+
+        explicit flat_set(const Compare &compare) : cmp(compare) {}
+
+        template<class InputIt>
+        flat_set(InputIt first, InputIt last) {
+            insert(first, last);
+        }
+
+        void swap(flat_set &other) noexcept {
+            _keys.swap(other._keys);
+            std::swap(cmp, other.cmp);
+        }
+
+        const_iterator begin() const {
+            return at_position(0);
+        }
+
+        const_iterator cbegin() const {
+            return at_position(0);
+        }
+
+        const_iterator end() const {
+            return at_position(_keys.size());
+        }
+
+        const_iterator cend() const {
+            return at_position(_keys.size());
+        }
+
+        bool empty() const {
+            return _keys.empty();
+        }
+
+        size_t size() const {
+            return _keys.size();
+        }
+
+        void clear() {
+            _keys.clear();
+        }
+
+        pair<const_iterator, bool> insert(const Key &key) {
+            size_t pos = lower(key);
+            if (found(pos, key)) return pair<const_iterator, bool>(at_position(pos), false);
+            _keys.insert(pos, key);
+            return pair<const_iterator, bool>(at_position(pos), true);
+        }
+
+        /**
+         * insert every key of [first, last) that is not present, in one merge like
+         * flat_map::insert(first, last).
+         */
+        template<class InputIt>
+        void insert(InputIt first, InputIt last) {
+            size_t n = _keys.size();
+            try {
+                for (; first != last; ++first) _keys.push_back(*first);
+                vector<Key> keys;
+                Key *k = _keys.data();
+                size_t total = _keys.size();
+                bool merged = detail::flat_merge(k, n, total - n, cmp, [&](size_t from) {
+                    if (keys.empty()) keys.reserve(total);
+                    keys.push_back(std::move_if_noexcept(k[from]));
+                });
+                if (merged) _keys = std::move(keys);
+            } catch (...) {
+                while (_keys.size() > n) _keys.pop_back();
+                throw;
+            }
+        }
+
+        const_iterator erase(const_iterator pos) {
+            int index = pos - cbegin();
+            if (index < 0 || (size_t) index >= _keys.size()) throw sjtu::invalid_iterator();
+            _keys.erase(index);
+            return at_position(index);
+        }
+
+        size_t erase(const Key &key) {
+            size_t pos = lower(key);
+            if (!found(pos, key)) return 0;
+            _keys.erase(pos);
+            return 1;
+        }
+
+        size_t count(const Key &key) const {
+            return found(lower(key), key) ? 1 : 0;
+        }
+
+        const_iterator find(const Key &key) const {
+            size_t pos = lower(key);
+            return found(pos, key) ? at_position(pos) : cend();
+        }
+
+        const_iterator lower_bound(const Key &key) const {
+            return at_position(lower(key));
+        }
+
+        const_iterator upper_bound(const Key &key) const {
+            return at_position(upper(key));
+        }
+    };
+
+    template<class Key, class Compare>
+    void swap(flat_set<Key, Compare> &a, flat_set<Key, Compare> &b) noexcept {
+        a.swap(b);
+    }
+}
+
+#endif
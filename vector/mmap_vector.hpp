@@ -0,0 +1,562 @@
+#ifndef SJTU_MMAP_VECTOR_HPP
+#define SJTU_MMAP_VECTOR_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sjtu {
+    /**
+     * a vector of trivially copyable T kept in a memory-mapped file, which is a plain
+     * array of T (no header), so opening it read-only maps the data in place without
+     * reading it and the pages are shared through the page cache by every process.
+     * it has the access and iterator api of sjtu::vector; growth extends the file with
+     * ftruncate and remaps it, so like vector it invalidates pointers and iterators.
+     * while open for writing the file may be longer than size() elements, it is cut
+     * back on close.
+     * all the failures of the system calls throw runtime_error.
+     * a read-only vector is mapped private: the pages are shared until one is written
+     * through the non-const accessors, which then gets a private copy that never
+     * reaches the file. changing the size throws runtime_error.
+     */
+    template<typename T>
+    class mmap_vector {
+        static_assert(std::is_trivially_copyable<T>::value, "mmap_vector needs a trivially copyable T");
+
+    public:
+        enum open_mode {
+            read_only,   // the file must exist and is never changed
+            read_write,  // open or create the file and keep what it holds
+            truncate     // create the file or empty it
+        };
+
+        enum access_advice {
+            normal = MADV_NORMAL,
+            sequential = MADV_SEQUENTIAL,
+            random = MADV_RANDOM,
+            will_need = MADV_WILLNEED,
+            dont_need = MADV_DONTNEED
+        };
+
+        class const_iterator;
+
+        /**
+         * a pointer into the mapping with ptrdiff_t arithmetic, so that files of more
+         * than INT_MAX elements work; iterators of different vectors do not subtract.
+         */
+        class iterator {
+            friend class mmap_vector;
+            friend class const_iterator;
+
+        private:
+            T *_p;
+            T *_head;
+
+            iterator(T *p, T *head) : _p(p), _head(head) {}
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef T * pointer;
+            typedef T & reference;
+
+            iterator() : _p(nullptr), _head(nullptr) {}
+
+            iterator operator+(difference_type n) const {
+                return iterator(_p + n, _head);
+            }
+
+            iterator operator-(difference_type n) const {
+                return iterator(_p - n, _head);
+            }
+
+            difference_type operator-(const iterator &rhs) const {
+                if (_head != rhs._head) throw sjtu::invalid_iterator();
+                return _p - rhs._p;
+            }
+
+            iterator &operator+=(difference_type n) {
+                _p += n;
+                return *this;
+            }
+
+            iterator &operator-=(difference_type n) {
+                _p -= n;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator tmp = *this;
+                _p++;
+                return tmp;
+            }
+
+            iterator &operator++() {
+                _p++;
+                return *this;
+            }
+
+            iterator operator--(int) {
+                iterator tmp = *this;
+                _p--;
+                return tmp;
+            }
+
+            iterator &operator--() {
+                _p--;
+                return *this;
+            }
+
+            T &operator*() const {
+                return *_p;
+            }
+
+            T *operator->() const {
+                return _p;
+            }
+
+            T &operator[](difference_type n) const {
+                return _p[n];
+            }
+
+            bool operator<(const iterator &rhs) const {
+                return _p < rhs._p;
+            }
+
+            bool operator>(const iterator &rhs) const {
+                return _p > rhs._p;
+            }
+
+            bool operator<=(const iterator &rhs) const {
+                return _p <= rhs._p;
+            }
+
+            bool operator>=(const iterator &rhs) const {
+                return _p >= rhs._p;
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return _p == rhs._p;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return _p != rhs._p;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return _p == rhs._p;
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return _p != rhs._p;
+            }
+        };
+
+        class const_iterator {
+            friend class mmap_vector;
+            friend class iterator;
+
+        private:
+            const T *_p;
+            const T *_head;
+
+            const_iterator(const T *p, const T *head) : _p(p), _head(head) {}
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T * pointer;
+            typedef const T & reference;
+
+            const_iterator() : _p(nullptr), _head(nullptr) {}
+
+            const_iterator(const iterator &other) : _p(other._p), _head(other._head) {}
+
+            const_iterator operator+(difference_type n) const {
+                return const_iterator(_p + n, _head);
+            }
+
+            const_iterator operator-(difference_type n) const {
+                return const_iterator(_p - n, _head);
+            }
+
+            difference_type operator-(const const_iterator &rhs) const {
+                if (_head != rhs._head) throw sjtu::invalid_iterator();
+                return _p - rhs._p;
+            }
+
+            const_iterator &operator+=(difference_type n) {
+                _p += n;
+                return *this;
+            }
+
+            const_iterator &operator-=(difference_type n) {
+                _p -= n;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                _p++;
+                return tmp;
+            }
+
+            const_iterator &operator++() {
+                _p++;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                _p--;
+                return tmp;
+            }
+
+            const_iterator &operator--() {
+                _p--;
+                return *this;
+            }
+
+            const T &operator*() const {
+                return *_p;
+            }
+
+            const T *operator->() const {
+                return _p;
+            }
+
+            const T &operator[](difference_type n) const {
+                return _p[n];
+            }
+
+            bool operator<(const const_iterator &rhs) const {
+                return _p < rhs._p;
+            }
+
+            bool operator>(const const_iterator &rhs) const {
+                return _p > rhs._p;
+            }
+
+            bool operator<=(const const_iterator &rhs) const {
+                return _p <= rhs._p;
+            }
+
+            bool operator>=(const const_iterator &rhs) const {
+                return _p >= rhs._p;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return _p == rhs._p;
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return _p != rhs._p;
+            }
+        };
+
+    private:
+        int _fd;
+        bool _writable;
+        T *_data;
+        size_t _size;
+        size_t _capacity;
+
+        static size_t bytes(size_t n) { return n * sizeof(T); }
+
+        void fail() {
+            throw sjtu::runtime_error();
+        }
+
+        void check_writable() {
+            if (!_writable) fail();
+        }
+
+        /**
+         * map the first capacity elements of the file, which must be that long;
+         * a read-only file copy-on-write, so writes to its elements stay in memory.
+         */
+        void map(size_t capacity) {
+            _data = nullptr;
+            _capacity = capacity;
+            if (capacity == 0) return;
+            void *p = ::mmap(nullptr, bytes(capacity), PROT_READ | PROT_WRITE, _writable ? MAP_SHARED : MAP_PRIVATE,
+                             _fd, 0);
+            if (p == MAP_FAILED) fail();
+            _data = static_cast<T *>(p);
+        }
+
+        void unmap() {
+            if (_data != nullptr) ::munmap(_data, bytes(_capacity));
+            _data = nullptr;
+        }
+
+        /**
+         * extend the file to capacity elements and map all of it.
+         */
+        void remap(size_t capacity) {
+            if (::ftruncate(_fd, bytes(capacity)) != 0) fail();
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+            if (_data != nullptr) {
+                void *p = ::mremap(_data, bytes(_capacity), bytes(capacity), MREMAP_MAYMOVE);
+                if (p == MAP_FAILED) fail();
+                _data = static_cast<T *>(p);
+                _capacity = capacity;
+                return;
+            }
+#endif
+            unmap();
+            map(capacity);
+        }
+
+        void grow_for(size_t n) {
+            if (n <= _capacity) return;
+            size_t capacity = _capacity < 64 ? 64 : _capacity;
+            while (capacity < n) capacity *= 2;
+            remap(capacity);
+        }
+
+        void close() {
+            if (_fd < 0) return;
+            if (_writable) sync();
+            unmap();
+            int cut = _writable ? ::ftruncate(_fd, bytes(_size)) : 0;
+            ::close(_fd);
+            _fd = -1;
+            if (cut != 0) fail();
+        }
+
+    public:
+        mmap_vector() : _fd(-1), _writable(false), _data(nullptr), _size(0), _capacity(0) {}
+
+        /**
+         * open path; a read_only file must exist and hold a whole number of elements.
+         */
+        explicit mmap_vector(const std::string &path, open_mode mode = read_write)
+                : _fd(-1), _writable(mode != read_only), _data(nullptr), _size(0), _capacity(0) {
+            int flags = mode == read_only ? O_RDONLY : O_RDWR | O_CREAT;
+            if (mode == truncate) flags |= O_TRUNC;
+            _fd = ::open(path.c_str(), flags, 0644);
+            if (_fd < 0) fail();
+            struct stat st;
+            if (::fstat(_fd, &st) != 0 || st.st_size % sizeof(T) != 0) {
+                ::close(_fd);
+                fail();
+            }
+            _size = st.st_size / sizeof(T);
+            try {
+                map(_size);
+            } catch (...) {
+                ::close(_fd);
+                throw;
+            }
+        }
+
+        mmap_vector(const mmap_vector &) = delete;
+
+        mmap_vector &operator=(const mmap_vector &) = delete;
+
+        mmap_vector(mmap_vector &&other) noexcept
+                : _fd(other._fd), _writable(other._writable), _data(other._data), _size(other._size),
+                  _capacity(other._capacity) {
+            other._fd = -1;
+            other._data = nullptr;
+            other._size = other._capacity = 0;
+        }
+
+        mmap_vector &operator=(mmap_vector &&other) noexcept {
+            if (this == &other) return *this;
+            mmap_vector tmp(std::move(other));
+            swap(tmp);
+            return *this;
+        }
+
+        void swap(mmap_vector &other) noexcept {
+            std::swap(_fd, other._fd);
+            std::swap(_writable, other._writable);
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            std::swap(_capacity, other._capacity);
+        }
+
+        /**
+         * cut the file to size() elements and unmap it.
+         */
+        ~mmap_vector() {
+            try {
+                close();
+            } catch (...) {}
+        }
+
+        T &at(const size_t &pos) {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return _data[pos];
+        }
+
+        const T &at(const size_t &pos) const {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return _data[pos];
+        }
+
+        T &operator[](const size_t &pos) { return at(pos); }
+
+        const T &operator[](const size_t &pos) const { return at(pos); }
+
+        const T &front() const {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return _data[0];
+        }
+
+        const T &back() const {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return _data[_size - 1];
+        }
+
+        /**
+         * the mapped elements, nullptr while the file is empty.
+         */
+        T *data() { return _data; }
+
+        const T *data() const { return _data; }
+
+        iterator begin() { return iterator(_data, _data); }
+
+        const_iterator begin() const { return cbegin(); }
+
+        const_iterator cbegin() const { return const_iterator(_data, _data); }
+
+        iterator end() { return iterator(_data + _size, _data); }
+
+        const_iterator end() const { return cend(); }
+
+        const_iterator cend() const { return const_iterator(_data + _size, _data); }
+
+        bool empty() const { return _size == 0; }
+
+        size_t size() const { return _size; }
+
+        size_t capacity() const { return _capacity; }
+
+        bool is_open() const { return _fd >= 0; }
+
+        bool writable() const { return _writable; }
+
+        /**
+         * make room for n elements so the next pushes do not remap.
+         */
+        void reserve(size_t n) {
+            check_writable();
+            grow_for(n);
+        }
+
+        /**
+         * new elements are zero, which is what ftruncate fills the file with.
+         */
+        void resize(size_t n) {
+            check_writable();
+            grow_for(n);
+            if (n > _size) memset(static_cast<void *>(_data + _size), 0, bytes(n - _size));
+            _size = n;
+        }
+
+        void clear() {
+            check_writable();
+            _size = 0;
+        }
+
+        iterator insert(iterator pos, const T &value) {
+            return insert(pos - begin(), value);
+        }
+
+        iterator insert(const size_t &ind, const T &value) {
+            check_writable();
+            if (ind > _size) throw sjtu::index_out_of_bound();
+            T copy = value;  // value may live in the mapping that is about to move
+            grow_for(_size + 1);
+            memmove(static_cast<void *>(_data + ind + 1), _data + ind, bytes(_size - ind));
+            _data[ind] = copy;
+            _size++;
+            return begin() + ind;
+        }
+
+        iterator erase(iterator pos) {
+            return erase(pos - begin());
+        }
+
+        iterator erase(const size_t &ind) {
+            check_writable();
+            if (ind >= _size) throw sjtu::index_out_of_bound();
+            memmove(static_cast<void *>(_data + ind), _data + ind + 1, bytes(_size - ind - 1));
+            _size--;
+            return begin() + ind;
+        }
+
+        void push_back(const T &value) {
+            check_writable();
+            if (_size == _capacity) {
+                T copy = value;
+                grow_for(_size + 1);
+                _data[_size++] = copy;
+                return;
+            }
+            _data[_size++] = value;
+        }
+
+        /**
+         * append n elements from src with one copy.
+         */
+        void append(const T *src, size_t n) {
+            check_writable();
+            grow_for(_size + n);
+            memcpy(static_cast<void *>(_data + _size), src, bytes(n));
+            _size += n;
+        }
+
+        void pop_back() {
+            check_writable();
+            if (_size == 0) throw sjtu::container_is_empty();
+            _size--;
+        }
+
+        /**
+         * write the dirty pages back, blocking unless async. the mapping stays where
+         * it is, so pointers and iterators remain valid.
+         */
+        void sync(bool async = false) {
+            if (!_writable || _fd < 0) return;
+            if (_data != nullptr && ::msync(_data, bytes(_size), async ? MS_ASYNC : MS_SYNC) != 0) fail();
+        }
+
+        /**
+         * madvise over the elements [first, first + n), all of them by default.
+         */
+        void advise(access_advice advice, size_t first = 0, size_t n = (size_t) -1) {
+            if (_data == nullptr || first >= _size) return;
+            if (n > _size - first) n = _size - first;
+            // madvise wants a page aligned start
+            size_t page = ::sysconf(_SC_PAGESIZE);
+            char *begin = reinterpret_cast<char *>(_data + first), *end = reinterpret_cast<char *>(_data + first + n);
+            char *aligned = reinterpret_cast<char *>(reinterpret_cast<uintptr_t>(begin) / page * page);
+            if (::madvise(aligned, end - aligned, advice) != 0) fail();
+        }
+    };
+
+    template<typename T>
+    void swap(mmap_vector<T> &a, mmap_vector<T> &b) noexcept {
+        a.swap(b);
+    }
+}
+
+#endif
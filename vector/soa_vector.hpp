@@ -0,0 +1,482 @@
+#ifndef SJTU_SOA_VECTOR_HPP
+#define SJTU_SOA_VECTOR_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+    /**
+     * a contiguous run of one column of a soa_vector, for loops and vector kernels.
+     * at() and operator[] are checked like vector's, data() / begin() / end() are not.
+     */
+    template<typename T>
+    class soa_span {
+    private:
+        T *_data;
+        size_t _size;
+
+    public:
+        soa_span(T *data, size_t size) : _data(data), _size(size) {}
+
+        T *data() const { return _data; }
+
+        size_t size() const { return _size; }
+
+        bool empty() const { return _size == 0; }
+
+        T *begin() const { return _data; }
+
+        T *end() const { return _data + _size; }
+
+        T &at(const size_t &pos) const {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return _data[pos];
+        }
+
+        T &operator[](const size_t &pos) const { return at(pos); }
+    };
+
+    /**
+     * a vector of records stored column by column: soa_vector<long long, int, double>
+     * keeps one array per field, all sharing size and capacity, so a scan over one
+     * field reads only that field's cache lines.
+     * every column starts on a column_alignment byte boundary and the capacity is a
+     * multiple of 16, so column<I>() can be handed to aligned vector loops.
+     * rows are read and written through the row_reference proxy that operator[] returns.
+     * growth and exceptions follow vector: the capacity doubles, rows are moved if no
+     * field's move can throw and copied otherwise, so a throwing copy leaves the vector
+     * as it was, and a bad position throws index_out_of_bound.
+     */
+    template<typename... Fields>
+    class soa_vector {
+        static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+
+    public:
+        static const size_t column_alignment = 64;
+
+        template<size_t I>
+        using field_type = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+        typedef std::tuple<Fields...> value_type;
+
+        /**
+         * counters kept when compiled with SJTU_STATS defined, all zero otherwise.
+         * SJTU_STATS changes the class layout: define it in every translation unit or in none.
+         * allocations counts columns, moves counts the field values relocated or shifted.
+         */
+        struct statistics {
+            size_t allocations = 0;
+            size_t bytes_allocated = 0;
+            size_t reallocations = 0;
+            size_t moves = 0;
+        };
+
+    private:
+        typedef std::tuple<Fields *...> columns;
+        typedef std::index_sequence_for<Fields...> fields;
+
+        columns _columns;
+        size_t _size;
+        size_t _capacity;
+#ifdef SJTU_STATS
+        statistics _stats;
+#endif
+
+        void note_allocation(size_t bytes) {
+#ifdef SJTU_STATS
+            _stats.allocations++;
+            _stats.bytes_allocated += bytes;
+#else
+            (void) bytes;
+#endif
+        }
+
+        void note_moves(size_t n) {
+#ifdef SJTU_STATS
+            _stats.moves += n * sizeof...(Fields);
+#else
+            (void) n;
+#endif
+        }
+
+        size_t grown_capacity() const {
+            return _capacity == 0 ? 16 : _capacity * 2;
+        }
+
+        template<size_t... I>
+        columns allocate(size_t capacity, std::index_sequence<I...>) {
+            columns fresh;
+            size_t done = 0;
+            try {
+                ((std::get<I>(fresh) = static_cast<field_type<I> *>(
+                        ::operator new(capacity * sizeof(field_type<I>), std::align_val_t(column_alignment))),
+                  note_allocation(capacity * sizeof(field_type<I>)), done++), ...);
+            } catch (...) {
+                ((I < done ? ::operator delete(std::get<I>(fresh), std::align_val_t(column_alignment)) : void()), ...);
+                throw;
+            }
+            return fresh;
+        }
+
+        template<size_t... I>
+        static void deallocate(columns &cols, std::index_sequence<I...>) {
+            ((::operator delete(std::get<I>(cols), std::align_val_t(column_alignment))), ...);
+        }
+
+        template<class F>
+        static void destroy(F *p) {
+            p->~F();
+        }
+
+        /**
+         * destroy the first count fields of row at.
+         */
+        template<size_t... I>
+        static void destroy_fields(columns &cols, size_t at, size_t count, std::index_sequence<I...>) {
+            ((I < count ? destroy(std::get<I>(cols) + at) : void()), ...);
+        }
+
+        template<size_t... I, class... Args>
+        static void construct_row(columns &cols, size_t at, std::index_sequence<I...>, Args &&... values) {
+            size_t done = 0;
+            try {
+                ((::new(static_cast<void *>(std::get<I>(cols) + at)) field_type<I>(std::forward<Args>(values)),
+                  done++), ...);
+            } catch (...) {
+                destroy_fields(cols, at, done, fields());
+                throw;
+            }
+        }
+
+        template<size_t... I>
+        static void destroy_rows(columns &cols, size_t from, size_t to, std::index_sequence<I...> seq) {
+            for (size_t at = from; at < to; at++) destroy_fields(cols, at, sizeof...(I), seq);
+        }
+
+        /**
+         * a row moves as a unit: if one field's move may throw, every copyable field is
+         * copied, so that a throw part way leaves all the old rows intact.
+         */
+        static const bool nothrow_relocate = (std::is_nothrow_move_constructible<Fields>::value && ...);
+
+        template<class F>
+        static typename std::conditional<nothrow_relocate || !std::is_copy_constructible<F>::value,
+                F &&, const F &>::type relocated(F &value) {
+            return std::move(value);
+        }
+
+        /**
+         * build the rows into to; if a copy throws, the rows built so far are destroyed
+         * again and the old columns are untouched.
+         */
+        template<size_t... I>
+        void move_rows(columns &to, std::index_sequence<I...> seq) {
+            size_t at = 0;
+            try {
+                for (; at < _size; at++) construct_row(to, at, seq, relocated(std::get<I>(_columns)[at])...);
+            } catch (...) {
+                destroy_rows(to, 0, at, seq);
+                throw;
+            }
+        }
+
+        /**
+         * move the rows into fresh columns of the given capacity, then free the old ones.
+         * on a throw the caller still owns fresh and frees it.
+         */
+        void relocate(columns &fresh, size_t capacity) {
+            move_rows(fresh, fields());
+#ifdef SJTU_STATS
+            _stats.reallocations++;
+#endif
+            note_moves(_size);
+            if (_capacity != 0) {
+                destroy_rows(_columns, 0, _size, fields());
+                deallocate(_columns, fields());
+            }
+            _columns = fresh;
+            _capacity = capacity;
+        }
+
+        template<size_t... I>
+        void shift_down(size_t ind, std::index_sequence<I...>) {
+            for (size_t at = ind; at + 1 < _size; at++) {
+                ((std::get<I>(_columns)[at] = std::move(std::get<I>(_columns)[at + 1])), ...);
+            }
+        }
+
+        template<size_t... I>
+        void copy_from(const soa_vector &other, std::index_sequence<I...>) {
+            for (; _size < other._size; _size++) {
+                construct_row(_columns, _size, fields(), std::get<I>(other._columns)[_size]...);
+            }
+        }
+
+        template<size_t... I>
+        value_type row_values(size_t at, std::index_sequence<I...>) const {
+            return value_type(std::get<I>(_columns)[at]...);
+        }
+
+        template<size_t... I>
+        void assign_row(size_t at, const value_type &values, std::index_sequence<I...>) {
+            ((std::get<I>(_columns)[at] = std::get<I>(values)), ...);
+        }
+
+        template<class... Args>
+        void emplace_row(Args &&... values) {
+            if (_size == _capacity) {
+                // the values may live in the old columns, so the new row is built first
+                size_t capacity = grown_capacity();
+                columns fresh = allocate(capacity, fields());
+                try {
+                    construct_row(fresh, _size, fields(), std::forward<Args>(values)...);
+                } catch (...) {
+                    deallocate(fresh, fields());
+                    throw;
+                }
+                try {
+                    relocate(fresh, capacity);
+                } catch (...) {
+                    destroy_rows(fresh, _size, _size + 1, fields());
+                    deallocate(fresh, fields());
+                    throw;
+                }
+            } else {
+                construct_row(_columns, _size, fields(), std::forward<Args>(values)...);
+            }
+            _size++;
+        }
+
+        template<size_t... I>
+        void emplace_tuple(const value_type &values, std::index_sequence<I...>) {
+            emplace_row(std::get<I>(values)...);
+        }
+
+    public:
+        class const_row_reference;
+
+        /**
+         * one row of a soa_vector, get<I>() is the I-th field; assigning a row or a
+         * tuple writes the fields, the reference itself is never rebound.
+         */
+        class row_reference {
+            friend class soa_vector;
+            friend class const_row_reference;
+
+        private:
+            soa_vector *_owner;
+            size_t _index;
+
+            row_reference(soa_vector *owner, size_t index) : _owner(owner), _index(index) {}
+
+        public:
+            template<size_t I>
+            field_type<I> &get() const {
+                return std::get<I>(_owner->_columns)[_index];
+            }
+
+            operator value_type() const {
+                return _owner->row_values(_index, fields());
+            }
+
+            row_reference &operator=(const value_type &values) {
+                _owner->assign_row(_index, values, fields());
+                return *this;
+            }
+
+            row_reference &operator=(const row_reference &other) {
+                return *this = (value_type) other;
+            }
+        };
+
+        class const_row_reference {
+            friend class soa_vector;
+
+        private:
+            const soa_vector *_owner;
+            size_t _index;
+
+            const_row_reference(const soa_vector *owner, size_t index) : _owner(owner), _index(index) {}
+
+        public:
+            const_row_reference(const row_reference &other) : _owner(other._owner), _index(other._index) {}
+
+            template<size_t I>
+            const field_type<I> &get() const {
+                return std::get<I>(_owner->_columns)[_index];
+            }
+
+            operator value_type() const {
+                return _owner->row_values(_index, fields());
+            }
+        };
+
+        soa_vector() : _size(0), _capacity(0) {}
+
+        soa_vector(const soa_vector &other) : _size(0), _capacity(0) {
+            if (other._size == 0) return;
+            _columns = allocate(other._capacity, fields());
+            _capacity = other._capacity;
+            try {
+                copy_from(other, fields());
+            } catch (...) {
+                destroy_rows(_columns, 0, _size, fields());
+                deallocate(_columns, fields());
+                throw;
+            }
+        }
+
+        /**
+         * take the columns of other, which is left empty.
+         */
+        soa_vector(soa_vector &&other) noexcept : _columns(other._columns), _size(other._size),
+                                                  _capacity(other._capacity) {
+            other._size = 0;
+            other._capacity = 0;
+        }
+
+        ~soa_vector() {
+            if (_capacity != 0) {
+                destroy_rows(_columns, 0, _size, fields());
+                deallocate(_columns, fields());
+            }
+        }
+
+        soa_vector &operator=(const soa_vector &other) {
+            if (this == &other) return *this;
+            soa_vector tmp(other);
+            swap(tmp);
+            return *this;
+        }
+
+        soa_vector &operator=(soa_vector &&other) noexcept {
+            if (this == &other) return *this;
+            soa_vector tmp(std::move(other));
+            swap(tmp);
+            return *this;
+        }
+
+        void swap(soa_vector &other) noexcept {
+            std::swap(_columns, other._columns);
+            std::swap(_size, other._size);
+            std::swap(_capacity, other._capacity);
+        }
+
+        row_reference at(const size_t &pos) {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return row_reference(this, pos);
+        }
+
+        const_row_reference at(const size_t &pos) const {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return const_row_reference(this, pos);
+        }
+
+        row_reference operator[](const size_t &pos) {
+            return at(pos);
+        }
+
+        const_row_reference operator[](const size_t &pos) const {
+            return at(pos);
+        }
+
+        const_row_reference front() const {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return const_row_reference(this, 0);
+        }
+
+        const_row_reference back() const {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return const_row_reference(this, _size - 1);
+        }
+
+        /**
+         * the I-th field of every row, column_alignment aligned once anything was pushed.
+         */
+        template<size_t I>
+        soa_span<field_type<I>> column() {
+            return soa_span<field_type<I>>(_capacity == 0 ? nullptr : std::get<I>(_columns), _size);
+        }
+
+        template<size_t I>
+        soa_span<const field_type<I>> column() const {
+            return soa_span<const field_type<I>>(_capacity == 0 ? nullptr : std::get<I>(_columns), _size);
+        }
+
+        bool empty() const {
+            return _size == 0;
+        }
+
+        size_t size() const {
+            return _size;
+        }
+
+        size_t capacity() const {
+            return _capacity;
+        }
+
+        void reserve(size_t n) {
+            if (n <= _capacity) return;
+            n = (n + 15) / 16 * 16;
+            columns fresh = allocate(n, fields());
+            try {
+                relocate(fresh, n);
+            } catch (...) {
+                deallocate(fresh, fields());
+                throw;
+            }
+        }
+
+        void clear() {
+            if (_capacity != 0) destroy_rows(_columns, 0, _size, fields());
+            _size = 0;
+        }
+
+        void push_back(const Fields &... values) {
+            emplace_row(values...);
+        }
+
+        void push_back(const value_type &values) {
+            emplace_tuple(values, fields());
+        }
+
+        void pop_back() {
+            if (_size == 0) throw sjtu::container_is_empty();
+            _size--;
+            destroy_fields(_columns, _size, sizeof...(Fields), fields());
+        }
+
+        void erase(const size_t &ind) {
+            if (ind >= _size) throw sjtu::index_out_of_bound();
+            shift_down(ind, fields());
+            note_moves(_size - 1 - ind);
+            pop_back();
+        }
+
+        statistics stats() const {
+#ifdef SJTU_STATS
+            return _stats;
+#else
+            return statistics();
+#endif
+        }
+
+        void reset_stats() {
+#ifdef SJTU_STATS
+            _stats = statistics();
+#endif
+        }
+    };
+
+    template<typename... Fields>
+    void swap(soa_vector<Fields...> &a, soa_vector<Fields...> &b) noexcept {
+        a.swap(b);
+    }
+}
+
+#endif
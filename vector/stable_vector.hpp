@@ -0,0 +1,680 @@
+#ifndef SJTU_STABLE_VECTOR_HPP
+#define SJTU_STABLE_VECTOR_HPP
+
+#include "exceptions.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace sjtu {
+    /**
+     * a vector whose elements never move: storage is a directory of blocks of
+     * 8, 16, 32, ... up to 4096 slots, so growing adds a block instead of copying
+     * and element i is found with one bit scan or one shift.
+     * push_front fills a second block sequence from its end, so both ends are
+     * amortized O(1) and pushes and pops at either end keep every pointer and
+     * reference to the other elements valid. a block that pops have drained is
+     * reused for later pushes, so a queue of bounded length stops allocating.
+     * iterators remember their place in a block and, like vector's, are invalidated
+     * by any insertion or removal; insert / erase shift values between slots, and
+     * the exceptions are the ones vector throws.
+     */
+    template<typename T>
+    class stable_vector {
+    public:
+        /**
+         * counters kept when compiled with SJTU_STATS defined, all zero otherwise.
+         * SJTU_STATS changes the class layout: define it in every translation unit or in none.
+         * moves counts the elements shifted by insert / erase, growth moves none.
+         */
+        struct statistics {
+            size_t allocations = 0;
+            size_t bytes_allocated = 0;
+            size_t moves = 0;
+        };
+
+    private:
+        static const int first_shift = 3;
+        static const int last_shift = 12;
+        static const size_t doubling_blocks = last_shift - first_shift;
+
+        /**
+         * slots 0, 1, 2, ... in blocks of doubling size up to 1 << last_shift,
+         * the live ones are [lo, hi).
+         */
+        struct segments {
+            T **dir = nullptr;
+            size_t blocks = 0;
+            size_t dir_capacity = 0;
+            size_t slots = 0;
+            size_t lo = 0;
+            size_t hi = 0;
+
+            size_t count() const { return hi - lo; }
+        };
+
+        std::allocator<T> alloc;
+        segments _front;  // element i of the front part is slot hi - 1 - i
+        segments _back;   // element i of the back part is slot lo + i
+#ifdef SJTU_STATS
+        statistics _stats;
+#endif
+
+        void note_allocation(size_t n) {
+#ifdef SJTU_STATS
+            _stats.allocations++;
+            _stats.bytes_allocated += n * sizeof(T);
+#else
+            (void) n;
+#endif
+        }
+
+        void note_moves(size_t n) {
+#ifdef SJTU_STATS
+            _stats.moves += n;
+#else
+            (void) n;
+#endif
+        }
+
+        static size_t block_size(size_t k) {
+            return (size_t) 1 << (first_shift + (k < doubling_blocks ? k : doubling_blocks));
+        }
+
+        /**
+         * the block holding slot p, and p's offset in it
+         */
+        static size_t block_of(size_t p, size_t &offset) {
+            size_t t = p + block_size(0);
+            if ((t >> last_shift) == 0) {
+                int top = (int) (sizeof(unsigned long long) * CHAR_BIT) - 1 - __builtin_clzll(t);
+                offset = t - ((size_t) 1 << top);
+                return top - first_shift;
+            }
+            offset = t & (((size_t) 1 << last_shift) - 1);
+            return doubling_blocks + (t >> last_shift) - 1;
+        }
+
+        static T *slot(const segments &s, size_t p) {
+            size_t offset;
+            size_t k = block_of(p, offset);
+            return s.dir[k] + offset;
+        }
+
+        /**
+         * make sure slot p exists; the directory may move, the blocks never do.
+         */
+        void reserve_slot(segments &s, size_t p) {
+            while (p >= s.slots) {
+                if (s.blocks == s.dir_capacity) {
+                    size_t capacity = s.dir_capacity == 0 ? 4 : s.dir_capacity * 2;
+                    T **dir = new T *[capacity];
+                    for (size_t k = 0; k < s.blocks; k++) dir[k] = s.dir[k];
+                    delete[] s.dir;
+                    s.dir = dir;
+                    s.dir_capacity = capacity;
+                }
+                s.dir[s.blocks] = alloc.allocate(block_size(s.blocks));
+                note_allocation(block_size(s.blocks));
+                s.slots += block_size(s.blocks);
+                s.blocks++;
+            }
+        }
+
+        void destroy_all(segments &s) {
+            for (size_t p = s.lo; p < s.hi; p++) alloc.destroy(slot(s, p));
+            s.lo = s.hi = 0;
+        }
+
+        void free_blocks(segments &s) {
+            destroy_all(s);
+            for (size_t k = 0; k < s.blocks; k++) alloc.deallocate(s.dir[k], block_size(k));
+            delete[] s.dir;
+            s = segments();
+        }
+
+        /**
+         * an emptied part starts again from slot 0, so its blocks are reused. once lo
+         * has left the first full-size block, that block moves to the end of the
+         * directory and the slots are renumbered down by its size: the elements stay
+         * where they are and the next pushes fill the drained block.
+         */
+        static void settle(segments &s) {
+            if (s.lo == s.hi) {
+                s.lo = s.hi = 0;
+                return;
+            }
+            size_t full = block_size(doubling_blocks);
+            if (s.lo < full - block_size(0) + full) return;
+            T *drained = s.dir[doubling_blocks];
+            for (size_t k = doubling_blocks; k + 1 < s.blocks; k++) s.dir[k] = s.dir[k + 1];
+            s.dir[s.blocks - 1] = drained;
+            s.lo -= full;
+            s.hi -= full;
+        }
+
+        /**
+         * where an iterator stands: p may move ahead / behind that many elements
+         * without leaving the live slots of its block; p == nullptr means not located.
+         */
+        struct cursor {
+            T *p = nullptr;
+            long long ahead = 0;
+            long long behind = 0;
+            int step = 1;
+
+            void advance(long long n) {
+                if (n <= ahead && -n <= behind) {
+                    p += n * step;
+                    ahead -= n;
+                    behind += n;
+                } else {
+                    p = nullptr;
+                }
+            }
+        };
+
+        cursor locate(size_t i) const {
+            cursor at;
+            size_t front = _front.count();
+            const segments &s = i < front ? _front : _back;
+            size_t p = i < front ? _front.hi - 1 - i : _back.lo + (i - front);
+            size_t offset;
+            size_t k = block_of(p, offset);
+            size_t start = p - offset;
+            size_t begin = start < s.lo ? s.lo : start, end = start + block_size(k);
+            if (end > s.hi) end = s.hi;
+            at.p = s.dir[k] + offset;
+            at.step = i < front ? -1 : 1;
+            at.ahead = i < front ? p - begin : end - 1 - p;
+            at.behind = i < front ? end - 1 - p : p - begin;
+            return at;
+        }
+
+        T &element(size_t i) const {
+            size_t front = _front.count();
+            if (i < front) return *slot(_front, _front.hi - 1 - i);
+            return *slot(_back, _back.lo + (i - front));
+        }
+
+        void steal(stable_vector &other) noexcept {
+            _front = other._front;
+            _back = other._back;
+            other._front = segments();
+            other._back = segments();
+        }
+
+    public:
+        class const_iterator;
+
+        class iterator {
+            friend class stable_vector;
+            friend class const_iterator;
+
+        private:
+            stable_vector *_owner;
+            size_t _index;
+            mutable cursor _at;
+
+            iterator(stable_vector *owner, size_t index, const cursor &at) : _owner(owner), _index(index), _at(at) {}
+
+            iterator moved(long long n) const {
+                iterator tmp = *this;
+                tmp += n;
+                return tmp;
+            }
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef T * pointer;
+            typedef T & reference;
+
+            iterator() : _owner(nullptr), _index(0) {}
+
+            iterator(stable_vector *owner, size_t index) : _owner(owner), _index(index) {}
+
+            iterator operator+(const int &n) const {
+                return moved(n);
+            }
+
+            iterator operator-(const int &n) const {
+                return moved(-(long long) n);
+            }
+
+            int operator-(const iterator &rhs) const {
+                if (_owner != rhs._owner) throw sjtu::invalid_iterator();
+                return (int) (_index - rhs._index);
+            }
+
+            iterator &operator+=(const int &n) {
+                _index += n;
+                _at.advance(n);
+                return *this;
+            }
+
+            iterator &operator-=(const int &n) {
+                _index -= n;
+                _at.advance(-(long long) n);
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator tmp = *this;
+                *this += 1;
+                return tmp;
+            }
+
+            iterator &operator++() {
+                return *this += 1;
+            }
+
+            iterator operator--(int) {
+                iterator tmp = *this;
+                *this -= 1;
+                return tmp;
+            }
+
+            iterator &operator--() {
+                return *this -= 1;
+            }
+
+            T & operator*() const {
+                if (_at.p == nullptr) _at = _owner->locate(_index);
+                return *_at.p;
+            }
+
+            T * operator->() const {
+                return &**this;
+            }
+
+            T & operator[](const int &n) const {
+                return _owner->element(_index + n);
+            }
+
+            bool operator<(const iterator &rhs) const {
+                return _index < rhs._index;
+            }
+
+            bool operator>(const iterator &rhs) const {
+                return _index > rhs._index;
+            }
+
+            bool operator<=(const iterator &rhs) const {
+                return _index <= rhs._index;
+            }
+
+            bool operator>=(const iterator &rhs) const {
+                return _index >= rhs._index;
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return _owner == rhs._owner && _index == rhs._index;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return _owner == rhs._owner && _index == rhs._index;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        class const_iterator {
+            friend class stable_vector;
+            friend class iterator;
+
+        private:
+            const stable_vector *_owner;
+            size_t _index;
+            mutable cursor _at;
+
+            const_iterator(const stable_vector *owner, size_t index, const cursor &at) : _owner(owner), _index(index), _at(at) {}
+
+            const_iterator moved(long long n) const {
+                const_iterator tmp = *this;
+                tmp += n;
+                return tmp;
+            }
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T * pointer;
+            typedef const T & reference;
+
+            const_iterator() : _owner(nullptr), _index(0) {}
+
+            const_iterator(const stable_vector *owner, size_t index) : _owner(owner), _index(index) {}
+
+            const_iterator(const iterator &other) : _owner(other._owner), _index(other._index), _at(other._at) {}
+
+            const_iterator operator+(const int &n) const {
+                return moved(n);
+            }
+
+            const_iterator operator-(const int &n) const {
+                return moved(-(long long) n);
+            }
+
+            int operator-(const const_iterator &rhs) const {
+                if (_owner != rhs._owner) throw sjtu::invalid_iterator();
+                return (int) (_index - rhs._index);
+            }
+
+            const_iterator &operator+=(const int &n) {
+                _index += n;
+                _at.advance(n);
+                return *this;
+            }
+
+            const_iterator &operator-=(const int &n) {
+                _index -= n;
+                _at.advance(-(long long) n);
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                *this += 1;
+                return tmp;
+            }
+
+            const_iterator &operator++() {
+                return *this += 1;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                *this -= 1;
+                return tmp;
+            }
+
+            const_iterator &operator--() {
+                return *this -= 1;
+            }
+
+            const T & operator*() const {
+                if (_at.p == nullptr) _at = _owner->locate(_index);
+                return *_at.p;
+            }
+
+            const T * operator->() const {
+                return &**this;
+            }
+
+            const T & operator[](const int &n) const {
+                return _owner->element(_index + n);
+            }
+
+            bool operator<(const const_iterator &rhs) const {
+                return _index < rhs._index;
+            }
+
+            bool operator>(const const_iterator &rhs) const {
+                return _index > rhs._index;
+            }
+
+            bool operator<=(const const_iterator &rhs) const {
+                return _index <= rhs._index;
+            }
+
+            bool operator>=(const const_iterator &rhs) const {
+                return _index >= rhs._index;
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return _owner == rhs._owner && _index == rhs._index;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return _owner == rhs._owner && _index == rhs._index;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        stable_vector() {}
+
+        stable_vector(const stable_vector &other) {
+            try {
+                for (const_iterator it = other.cbegin(); it != other.cend(); ++it) push_back(*it);
+            } catch (...) {
+                free_blocks(_front);
+                free_blocks(_back);
+                throw;
+            }
+        }
+
+        /**
+         * take the blocks of other, which is left empty.
+         */
+        stable_vector(stable_vector &&other) noexcept {
+            steal(other);
+        }
+
+        ~stable_vector() {
+            free_blocks(_front);
+            free_blocks(_back);
+        }
+
+        stable_vector &operator=(const stable_vector &other) {
+            if (this == &other) return *this;
+            stable_vector tmp(other);
+            swap(tmp);
+            return *this;
+        }
+
+        stable_vector &operator=(stable_vector &&other) noexcept {
+            if (this == &other) return *this;
+            stable_vector tmp(std::move(other));
+            swap(tmp);
+            return *this;
+        }
+
+        void swap(stable_vector &other) noexcept {
+            std::swap(_front, other._front);
+            std::swap(_back, other._back);
+        }
+
+        T &at(const size_t &pos) {
+            if (pos >= size()) throw sjtu::index_out_of_bound();
+            return element(pos);
+        }
+
+        const T &at(const size_t &pos) const {
+            if (pos >= size()) throw sjtu::index_out_of_bound();
+            return element(pos);
+        }
+
+        T &operator[](const size_t &pos) {
+            if (pos >= size()) throw sjtu::index_out_of_bound();
+            return element(pos);
+        }
+
+        const T &operator[](const size_t &pos) const {
+            if (pos >= size()) throw sjtu::index_out_of_bound();
+            return element(pos);
+        }
+
+        const T &front() const {
+            if (empty()) throw sjtu::container_is_empty();
+            return element(0);
+        }
+
+        const T &back() const {
+            if (empty()) throw sjtu::container_is_empty();
+            return element(size() - 1);
+        }
+
+        iterator begin() {
+            return iterator(this, 0);
+        }
+
+        const_iterator cbegin() const {
+            return const_iterator(this, 0);
+        }
+
+        iterator end() {
+            return iterator(this, size());
+        }
+
+        const_iterator cend() const {
+            return const_iterator(this, size());
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        size_t size() const {
+            return _front.count() + _back.count();
+        }
+
+        /**
+         * destroy the elements but keep the blocks.
+         */
+        void clear() {
+            destroy_all(_front);
+            destroy_all(_back);
+        }
+
+        iterator insert(iterator pos, const T &value) {
+            int index = pos - begin();
+            return insert(index, value);
+        }
+
+        /**
+         * shifts the elements on the shorter side of ind by one slot.
+         */
+        iterator insert(const size_t &ind, const T &value) {
+            size_t n = size();
+            if (ind > n) throw sjtu::index_out_of_bound();
+            if (ind == n) {
+                push_back(value);
+                return begin() + ind;
+            }
+            if (ind == 0) {
+                push_front(value);
+                return begin();
+            }
+            T copy(value);
+            if (ind < n / 2) {
+                push_front(std::move(element(0)));
+                for (size_t i = 1; i < ind; i++) element(i) = std::move(element(i + 1));
+                note_moves(ind);
+            } else {
+                push_back(std::move(element(n - 1)));
+                for (size_t i = n - 1; i > ind; i--) element(i) = std::move(element(i - 1));
+                note_moves(n - ind);
+            }
+            element(ind) = std::move(copy);
+            return begin() + ind;
+        }
+
+        iterator erase(iterator pos) {
+            int index = pos - begin();
+            return erase(index);
+        }
+
+        iterator erase(const size_t &ind) {
+            size_t n = size();
+            if (ind >= n) throw sjtu::index_out_of_bound();
+            if (ind < n / 2) {
+                for (size_t i = ind; i > 0; i--) element(i) = std::move(element(i - 1));
+                note_moves(ind);
+                pop_front();
+            } else {
+                for (size_t i = ind; i + 1 < n; i++) element(i) = std::move(element(i + 1));
+                note_moves(n - 1 - ind);
+                pop_back();
+            }
+            return begin() + ind;
+        }
+
+        void push_back(const T &value) {
+            reserve_slot(_back, _back.hi);
+            alloc.construct(slot(_back, _back.hi), value);
+            _back.hi++;
+        }
+
+        void push_back(T &&value) {
+            reserve_slot(_back, _back.hi);
+            alloc.construct(slot(_back, _back.hi), std::move(value));
+            _back.hi++;
+        }
+
+        void push_front(const T &value) {
+            reserve_slot(_front, _front.hi);
+            alloc.construct(slot(_front, _front.hi), value);
+            _front.hi++;
+        }
+
+        void push_front(T &&value) {
+            reserve_slot(_front, _front.hi);
+            alloc.construct(slot(_front, _front.hi), std::move(value));
+            _front.hi++;
+        }
+
+        void pop_back() {
+            if (_back.count() > 0) {
+                alloc.destroy(slot(_back, --_back.hi));
+                settle(_back);
+            } else if (_front.count() > 0) {
+                alloc.destroy(slot(_front, _front.lo++));
+                settle(_front);
+            } else {
+                throw sjtu::container_is_empty();
+            }
+        }
+
+        void pop_front() {
+            if (_front.count() > 0) {
+                alloc.destroy(slot(_front, --_front.hi));
+                settle(_front);
+            } else if (_back.count() > 0) {
+                alloc.destroy(slot(_back, _back.lo++));
+                settle(_back);
+            } else {
+                throw sjtu::container_is_empty();
+            }
+        }
+
+        statistics stats() const {
+#ifdef SJTU_STATS
+            return _stats;
+#else
+            return statistics();
+#endif
+        }
+
+        void reset_stats() {
+#ifdef SJTU_STATS
+            _stats = statistics();
+#endif
+        }
+    };
+
+    template<typename T>
+    void swap(stable_vector<T> &a, stable_vector<T> &b) noexcept {
+        a.swap(b);
+    }
+}
+
+#endif
@@ -0,0 +1,319 @@
+#ifndef SJTU_STATIC_VECTOR_HPP
+#define SJTU_STATIC_VECTOR_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+    namespace detail {
+        /**
+         * the inline storage of static_vector, picked by what T allows:
+         * 0. trivial T: a plain array, so everything works in constant expressions
+         *    (which needs the array zeroed up front);
+         * 1. trivially copyable T: raw bytes, the whole vector stays trivially copyable;
+         * 2. anything else: raw bytes, elements constructed and destroyed one by one.
+         */
+        template<typename T, size_t N,
+                int Kind = std::is_trivial<T>::value ? 0 : std::is_trivially_copyable<T>::value ? 1 : 2>
+        class static_storage {
+        protected:
+            T _data[N == 0 ? 1 : N];
+            size_t _size;
+
+            constexpr static_storage() : _data(), _size(0) {}
+
+            constexpr T *ptr() { return _data; }
+
+            constexpr const T *ptr() const { return _data; }
+
+            template<class... Args>
+            constexpr void construct(size_t i, Args &&... args) {
+                _data[i] = T(std::forward<Args>(args)...);
+            }
+
+            constexpr void destroy(size_t) {}
+        };
+
+        template<typename T, size_t N>
+        class static_storage<T, N, 1> {
+        protected:
+            alignas(T) unsigned char _bytes[(N == 0 ? 1 : N) * sizeof(T)];
+            size_t _size;
+
+            static_storage() : _size(0) {}
+
+            T *ptr() { return reinterpret_cast<T *>(_bytes); }
+
+            const T *ptr() const { return reinterpret_cast<const T *>(_bytes); }
+
+            template<class... Args>
+            void construct(size_t i, Args &&... args) {
+                new(_bytes + i * sizeof(T)) T(std::forward<Args>(args)...);
+            }
+
+            void destroy(size_t) {}
+        };
+
+        template<typename T, size_t N>
+        class static_storage<T, N, 2> : public static_storage<T, N, 1> {
+            typedef static_storage<T, N, 1> base;
+
+        protected:
+            void destroy(size_t i) {
+                this->ptr()[i].~T();
+            }
+
+            void destroy_all() {
+                while (this->_size > 0) destroy(--this->_size);
+            }
+
+            template<class Source>
+            void take_all(Source &&other) {
+                try {
+                    for (; this->_size < other._size; this->_size++) {
+                        this->construct(this->_size, std::forward<Source>(other).element(this->_size));
+                    }
+                } catch (...) {
+                    destroy_all();
+                    throw;
+                }
+            }
+
+            const T &element(size_t i) const & { return this->ptr()[i]; }
+
+            T &&element(size_t i) && { return std::move(this->ptr()[i]); }
+
+            static_storage() {}
+
+            static_storage(const static_storage &other) : base() {
+                take_all(other);
+            }
+
+            static_storage(static_storage &&other) noexcept(std::is_nothrow_move_constructible<T>::value) : base() {
+                take_all(std::move(other));
+            }
+
+            static_storage &operator=(const static_storage &other) {
+                if (this == &other) return *this;
+                destroy_all();
+                take_all(other);
+                return *this;
+            }
+
+            static_storage &operator=(static_storage &&other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+                if (this == &other) return *this;
+                destroy_all();
+                take_all(std::move(other));
+                return *this;
+            }
+
+            ~static_storage() {
+                destroy_all();
+            }
+        };
+    }
+
+    /**
+     * a vector of at most N elements kept inline, with no allocation at all.
+     * it has the iterator and exception api of sjtu::vector, and pushing past N
+     * throws runtime_error.
+     * when T is trivially copyable so is static_vector<T, N>; when T is trivial
+     * (trivially copyable and default constructible) it also works in constant
+     * expressions, e.g. a lookup table built by a constexpr function.
+     */
+    template<typename T, size_t N>
+    class static_vector : private detail::static_storage<T, N> {
+        typedef detail::static_storage<T, N> storage;
+
+        using storage::_size;
+        using storage::ptr;
+        using storage::construct;
+        using storage::destroy;
+
+    public:
+        typedef typename vector<T>::iterator iterator;
+        typedef typename vector<T>::const_iterator const_iterator;
+
+        constexpr static_vector() {}
+
+        /**
+         * n copies of value, throws runtime_error if n > N.
+         */
+        constexpr static_vector(size_t n, const T &value) {
+            if (n > N) throw sjtu::runtime_error();
+            for (size_t i = 0; i < n; i++) push_back(value);
+        }
+
+        constexpr T &at(const size_t &pos) {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return ptr()[pos];
+        }
+
+        constexpr const T &at(const size_t &pos) const {
+            if (pos >= _size) throw sjtu::index_out_of_bound();
+            return ptr()[pos];
+        }
+
+        constexpr T &operator[](const size_t &pos) {
+            return at(pos);
+        }
+
+        constexpr const T &operator[](const size_t &pos) const {
+            return at(pos);
+        }
+
+        constexpr const T &front() const {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return ptr()[0];
+        }
+
+        constexpr const T &back() const {
+            if (_size == 0) throw sjtu::container_is_empty();
+            return ptr()[_size - 1];
+        }
+
+        constexpr T *data() {
+            return ptr();
+        }
+
+        constexpr const T *data() const {
+            return ptr();
+        }
+
+        iterator begin() {
+            return iterator(ptr(), ptr());
+        }
+
+        const_iterator cbegin() const {
+            return const_iterator(ptr(), ptr());
+        }
+
+        iterator end() {
+            return iterator(ptr() + _size, ptr());
+        }
+
+        const_iterator cend() const {
+            return const_iterator(ptr() + _size, ptr());
+        }
+
+        constexpr bool empty() const {
+            return _size == 0;
+        }
+
+        constexpr size_t size() const {
+            return _size;
+        }
+
+        static constexpr size_t capacity() {
+            return N;
+        }
+
+        constexpr bool full() const {
+            return _size == N;
+        }
+
+        constexpr void clear() {
+            while (_size > 0) destroy(--_size);
+        }
+
+        iterator insert(iterator pos, const T &value) {
+            int index = pos - begin();
+            return insert(index, value);
+        }
+
+        iterator insert(const size_t &ind, const T &value) {
+            insert_at(ind, value);
+            return begin() + ind;
+        }
+
+        /**
+         * insert without returning an iterator, for constant expressions.
+         */
+        constexpr void insert_at(const size_t &ind, const T &value) {
+            if (ind > _size) throw sjtu::index_out_of_bound();
+            if (_size == N) throw sjtu::runtime_error();
+            if (ind == _size) {
+                construct(_size++, value);
+                return;
+            }
+            T copy(value);
+            construct(_size, std::move(ptr()[_size - 1]));
+            for (size_t i = _size - 1; i > ind; i--) ptr()[i] = std::move(ptr()[i - 1]);
+            ptr()[ind] = std::move(copy);
+            _size++;
+        }
+
+        iterator erase(iterator pos) {
+            int index = pos - begin();
+            return erase(index);
+        }
+
+        iterator erase(const size_t &ind) {
+            erase_at(ind);
+            return begin() + ind;
+        }
+
+        constexpr void erase_at(const size_t &ind) {
+            if (ind >= _size) throw sjtu::index_out_of_bound();
+            for (size_t i = ind; i + 1 < _size; i++) ptr()[i] = std::move(ptr()[i + 1]);
+            destroy(--_size);
+        }
+
+        constexpr void push_back(const T &value) {
+            if (_size == N) throw sjtu::runtime_error();
+            construct(_size, value);
+            _size++;
+        }
+
+        constexpr void push_back(T &&value) {
+            if (_size == N) throw sjtu::runtime_error();
+            construct(_size, std::move(value));
+            _size++;
+        }
+
+        template<class... Args>
+        constexpr T &emplace_back(Args &&... args) {
+            if (_size == N) throw sjtu::runtime_error();
+            construct(_size, std::forward<Args>(args)...);
+            return ptr()[_size++];
+        }
+
+        constexpr void pop_back() {
+            if (_size == 0) throw sjtu::container_is_empty();
+            destroy(--_size);
+        }
+
+        /**
+         * swaps the elements one by one, O(max(size(), other.size())).
+         */
+        constexpr void swap(static_vector &other) noexcept(std::is_nothrow_move_constructible<T>::value &&
+                                                           std::is_nothrow_move_assignable<T>::value) {
+            static_vector *small = this, *large = &other;
+            if (small->_size > large->_size) small = &other, large = this;
+            for (size_t i = 0; i < small->_size; i++) {
+                T tmp(std::move(small->ptr()[i]));
+                small->ptr()[i] = std::move(large->ptr()[i]);
+                large->ptr()[i] = std::move(tmp);
+            }
+            for (size_t i = small->_size; i < large->_size; i++) {
+                small->construct(i, std::move(large->ptr()[i]));
+                large->destroy(i);
+            }
+            size_t n = small->_size;
+            small->_size = large->_size;
+            large->_size = n;
+        }
+    };
+
+    template<typename T, size_t N>
+    constexpr void swap(static_vector<T, N> &a, static_vector<T, N> &b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+}
+
+#endif
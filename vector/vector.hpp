@@ -5,15 +5,106 @@
 
 #include <climits>
 #include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu {
+    namespace detail {
+        /**
+         * std::allocator with buffers aligned to Align bytes, so the bulk kernels
+         * over vectors of numbers start on a cache line.
+         */
+        template<typename T, size_t Align>
+        struct aligned_allocator : std::allocator<T> {
+            T *allocate(size_t n) {
+                return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+            }
+
+            void deallocate(T *p, size_t) {
+                ::operator delete(p, std::align_val_t(Align));
+            }
+        };
+    }
+
     template<typename T>
     class vector {
+    public:
+        /**
+         * counters kept when compiled with SJTU_STATS defined, all zero otherwise.
+         * SJTU_STATS changes the class layout: define it in every translation unit or in none.
+         * moves counts the elements copied by reallocations and by insert / erase shifts.
+         */
+        struct statistics {
+            size_t allocations = 0;
+            size_t bytes_allocated = 0;
+            size_t reallocations = 0;
+            size_t moves = 0;
+        };
+
     private:
-        std::allocator<T> alloc;
+        typedef typename std::conditional<std::is_arithmetic<T>::value, detail::aligned_allocator<T, 64>,
+                std::allocator<T>>::type allocator_type;
+
+        allocator_type alloc;
         T *_data;
         int _size;
         int _capacity;
+#ifdef SJTU_STATS
+        statistics _stats;
+#endif
+
+        void note_allocation(size_t n) {
+#ifdef SJTU_STATS
+            _stats.allocations++;
+            _stats.bytes_allocated += n * sizeof(T);
+#else
+            (void) n;
+#endif
+        }
+
+        void note_reallocation(size_t n, size_t moved) {
+            note_allocation(n);
+#ifdef SJTU_STATS
+            _stats.reallocations++;
+#endif
+            note_moves(moved);
+        }
+
+        void note_moves(size_t n) {
+#ifdef SJTU_STATS
+            _stats.moves += n;
+#else
+            (void) n;
+#endif
+        }
+
+        /**
+         * the next capacity when the vector is full
+         */
+        int grown_capacity() const {
+            return _capacity == 0 ? 5 : _capacity * 2;
+        }
+
+        /**
+         * move [_data, _data + _size) into new_data, skipping the slot at gap
+         * (gap == _size skips none), then free the old buffer and adopt new_data.
+         * elements are moved if that can not throw, copied otherwise.
+         */
+        void relocate(T *new_data, int new_capacity, int gap) {
+            note_reallocation(new_capacity + 1, _size);
+            for (int i = 0; i < _size; i++) {
+                alloc.construct(new_data + (i < gap ? i : i + 1), std::move_if_noexcept(_data[i]));
+            }
+            if (_data != nullptr) {
+                for (int i = 0; i < _size; i++) alloc.destroy(_data + i);
+                alloc.deallocate(_data, _capacity + 1);
+            }
+            _data = new_data;
+            _capacity = new_capacity;
+        }
+
     public:
         class const_iterator;
 
@@ -173,6 +264,15 @@ namespace sjtu {
 
         vector() : _data(nullptr), _size(0), _capacity(0) {}
 
+        /**
+         * take the buffer of other, which is left empty.
+         */
+        vector(vector &&other) noexcept : _data(other._data), _size(other._size), _capacity(other._capacity) {
+            other._data = nullptr;
+            other._size = 0;
+            other._capacity = 0;
+        }
+
         vector(const vector &other) {
             if (other._size == 0) {
                 _size = 0;
@@ -182,6 +282,7 @@ namespace sjtu {
                 _size = other._size;
                 _capacity = other._capacity;
                 _data = alloc.allocate(_capacity + 1);
+                note_allocation(_capacity + 1);
                 for (int i = 0; i < _size; i++) alloc.construct(_data + i, other._data[i]);
             }
         }
@@ -206,32 +307,45 @@ namespace sjtu {
                 }
                 _capacity = other._capacity;
                 _data = alloc.allocate(_capacity + 1);
-                _size = other._size;
-            } else if (_size > other._size) {
+                note_allocation(_capacity + 1);
+            } else {
                 for (int i = 0; i < _size; i++) alloc.destroy(_data + i);
-                _size = other._size;
             }
+            _size = other._size;
             for (int i = 0; i < _size; i++) alloc.construct(_data + i, other._data[i]);
             return *this;
         }
 
+        vector &operator=(vector &&other) noexcept {
+            if (this == &other) return *this;
+            vector tmp(std::move(other));
+            swap(tmp);
+            return *this;
+        }
+
+        void swap(vector &other) noexcept {
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            std::swap(_capacity, other._capacity);
+        }
+
         T &at(const size_t &pos) {
-            if (pos < 0 || pos >= _size) throw sjtu::index_out_of_bound();
+            if (pos >= (size_t) _size) throw sjtu::index_out_of_bound();
             return _data[pos];
         }
 
         const T &at(const size_t &pos) const {
-            if (pos < 0 || pos >= _size) throw sjtu::index_out_of_bound();
+            if (pos >= (size_t) _size) throw sjtu::index_out_of_bound();
             return _data[pos];
         }
 
         T &operator[](const size_t &pos) {
-            if (pos < 0 || pos >= _size) throw sjtu::index_out_of_bound();
+            if (pos >= (size_t) _size) throw sjtu::index_out_of_bound();
             return _data[pos];
         }
 
         const T &operator[](const size_t &pos) const {
-            if (pos < 0 || pos >= _size) throw sjtu::index_out_of_bound();
+            if (pos >= (size_t) _size) throw sjtu::index_out_of_bound();
             return _data[pos];
         }
 
@@ -245,6 +359,18 @@ namespace sjtu {
             return _data[_size - 1];
         }
 
+        /**
+         * the elements as one array, nullptr before the first allocation;
+         * 64-byte aligned when T is arithmetic.
+         */
+        T *data() {
+            return _data;
+        }
+
+        const T *data() const {
+            return _data;
+        }
+
         iterator begin() {
             return iterator(_data, _data);
         }
@@ -270,6 +396,15 @@ namespace sjtu {
             return _size;
         }
 
+        /**
+         * make room for n elements, so that growing to n does not reallocate.
+         */
+        void reserve(size_t n) {
+            if ((int) n <= _capacity) return;
+            T *new_data = alloc.allocate(n + 1);
+            relocate(new_data, (int) n, _size);
+        }
+
         void clear() {
             for (int i = 0; i < _size; i++) alloc.destroy(_data + i);
             _size = 0;
@@ -281,38 +416,24 @@ namespace sjtu {
         }
 
         iterator insert(const size_t &ind, const T &value) {
-            if (ind > _size || ind < 0) throw sjtu::index_out_of_bound();
+            if (ind > (size_t) _size) throw sjtu::index_out_of_bound();
             if (_size == _capacity) {
-                int LastCap = _capacity;
-                if (_capacity == 0) {
-                    _capacity = 5;
-                } else {
-                    _capacity *= 2;
-                }
-                T *new_data = alloc.allocate(_capacity + 1);
-                for (int i = 0, j = 0; i < _size||_size == 0; i++) {
-                    if (i == ind) {
-                        alloc.construct(new_data + i, value);
-                        _size++;
-                    } else {
-                        alloc.construct(new_data + i, _data[j]);
-                        j++;
-                    }
-                }
-                if (_data != nullptr) {
-                    for (int i = 0; i < _size-1; i++) alloc.destroy(_data + i);
-                    alloc.deallocate(_data, LastCap + 1);
-                    _data = nullptr;
-                }
-                _data = new_data;
+                // value may live in the old buffer, so it is placed before the others move
+                int capacity = grown_capacity();
+                T *new_data = alloc.allocate(capacity + 1);
+                alloc.construct(new_data + ind, value);
+                relocate(new_data, capacity, ind);
+                _size++;
                 return begin() + ind;
             }
-            if (ind == _size) {
+            if (ind == (size_t) _size) {
                 alloc.construct(_data + _size, value);
             } else {
-                alloc.construct(_data + _size, _data[_size - 1]);
-                for (int i = _size - 1; i > ind; i--) _data[i] = _data[i - 1];
-                _data[ind] = value;
+                T copy(value);
+                alloc.construct(_data + _size, std::move(_data[_size - 1]));
+                for (int i = _size - 1; i > (int) ind; i--) _data[i] = std::move(_data[i - 1]);
+                _data[ind] = std::move(copy);
+                note_moves(_size - ind);
             }
             _size++;
             return begin() + ind;
@@ -324,31 +445,36 @@ namespace sjtu {
         }
 
         iterator erase(const size_t &ind) {
-            if (ind >= _size || ind < 0) throw sjtu::index_out_of_bound();
+            if (ind >= (size_t) _size) throw sjtu::index_out_of_bound();
             _size--;
-            for (size_t i = ind; i < _size; i++) _data[i] = _data[i + 1];
+            for (size_t i = ind; i < (size_t) _size; i++) _data[i] = std::move(_data[i + 1]);
+            note_moves(_size - ind);
             alloc.destroy(_data + _size);
             return begin() + ind;
         }
 
         void push_back(const T &value) {
             if (_size == _capacity) {
-                int LastCap = _capacity;
-                if (_capacity == 0) {
-                    _capacity = 5;
-                } else {
-                    _capacity *= 2;
-                }
-                T *new_data = alloc.allocate(_capacity + 1);
-                for (int i = 0; i < _size; i++) alloc.construct(new_data + i, _data[i]);
-                if (_data != nullptr) {
-                    for (int i = 0; i < _size; i++) alloc.destroy(_data + i);
-                    alloc.deallocate(_data, LastCap + 1);
-                    _data = nullptr;
-                }
-                _data = new_data;
+                // value may live in the old buffer, so it is placed before the others move
+                int capacity = grown_capacity();
+                T *new_data = alloc.allocate(capacity + 1);
+                alloc.construct(new_data + _size, value);
+                relocate(new_data, capacity, _size);
+            } else {
+                alloc.construct(_data + _size, value);
+            }
+            _size++;
+        }
+
+        void push_back(T &&value) {
+            if (_size == _capacity) {
+                int capacity = grown_capacity();
+                T *new_data = alloc.allocate(capacity + 1);
+                alloc.construct(new_data + _size, std::move(value));
+                relocate(new_data, capacity, _size);
+            } else {
+                alloc.construct(_data + _size, std::move(value));
             }
-            alloc.construct(_data + _size, value);
             _size++;
         }
 
@@ -360,6 +486,25 @@ namespace sjtu {
                 alloc.destroy(_data + _size);
             }
         }
+
+        statistics stats() const {
+#ifdef SJTU_STATS
+            return _stats;
+#else
+            return statistics();
+#endif
+        }
+
+        void reset_stats() {
+#ifdef SJTU_STATS
+            _stats = statistics();
+#endif
+        }
     };
+
+    template<typename T>
+    void swap(vector<T> &a, vector<T> &b) noexcept {
+        a.swap(b);
+    }
 }
 #endif
\ No newline at end of file